@@ -1,34 +1,9 @@
 #include "Polynomial.h"
+#include "Lagrange.h"
 #include <vector>
 #include <iostream>
 using namespace std;
 
-//constructs a Lagrange Interpolating Polynomial from points
-Polynomial lagrange(vector<pair<double, double>> points)
-{
-  Polynomial result;
-  for(int k = 0; k < points.size(); k++)
-  {
-    //we're going to accumulate a numerator and denominator and then divide them
-    Polynomial numerator = {1};
-    double denominator = 1;
-    for(int i = 0; i < points.size(); i++)
-    {
-      if(i == k)
-        continue;
-
-      double xk = points[k].first;
-      double xi = points[i].first;
-      numerator = numerator * Polynomial({-xi, 1});
-      denominator *= (xk-xi);
-    }
-
-    Polynomial l = numerator/denominator;
-    result = result + points[k].second * l;
-  }
-  return result;
-}
-
 int main()
 {
   vector<pair<double, double>> sample1 = {
@@ -64,12 +39,12 @@ int main()
   cout << "derivative of p1 = " << dp1 << endl;
   cout << "derivative of p2 = " << dp2 << endl;
 
-  //initial guesses are picked because they are the largest point's in the tabulated data
-  double criticalValue1 = dp1.root(10);
-  double criticalValue2 = dp2.root(10);
+  //search the whole tabulated interval so no initial guess is needed
+  Extremum<double> max1 = p1.globalMax(0, 28);
+  Extremum<double> max2 = p2.globalMax(0, 28);
 
-  cout << "p1 has a maximum of " << p1.evaluate(criticalValue1) << " at " << criticalValue1 << endl;
-  cout << "p2 has a maximum of " << p2.evaluate(criticalValue1) << " at " << criticalValue2 << endl;
+  cout << "p1 has a maximum of " << max1.value << " at " << max1.x << endl;
+  cout << "p2 has a maximum of " << max2.value << " at " << max2.x << endl;
 
   return 0;
 }
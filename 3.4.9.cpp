@@ -1,32 +1,30 @@
 #include "Polynomial.h"
+#include "DividedDifferences.h"
 #include <vector>
 #include <iostream>
 using namespace std;
 
 int main()
 {
-  //Hermite polynomial calculated by hand
-  vector<double> coefficients = {0, 75, 0, 0.222222222, -0.031111111, -0.006444444, 0.002263889, -0.000913194, 0.000130527, -0.0000202236};
-  Polynomial distance = coefficients[0]
-                      + coefficients[1]*Polynomial({0, 1})
-                      + coefficients[2]*Polynomial({0,0,1})
-                      + coefficients[3]*Polynomial({0,0,1})*Polynomial({-3, 1})
-                      + coefficients[4]*Polynomial({0,0,1})*Polynomial({-3, 1}).power(2)
-                      + coefficients[5]*Polynomial({0,0,1})*Polynomial({-3, 1}).power(2)*Polynomial({-5, 1})
-                      + coefficients[6]*Polynomial({0,0,1})*Polynomial({-3, 1}).power(2)*Polynomial({-5, 1}).power(2)
-                      + coefficients[7]*Polynomial({0,0,1})*Polynomial({-3, 1}).power(2)*Polynomial({-5, 1}).power(2)*Polynomial({-8, 1})
-                      + coefficients[8]*Polynomial({0,0,1})*Polynomial({-3, 1}).power(2)*Polynomial({-5, 1}).power(2)*Polynomial({-8, 1}).power(2)
-                      + coefficients[9]*Polynomial({0,0,1})*Polynomial({-3, 1}).power(2)*Polynomial({-5, 1}).power(2)*Polynomial({-8, 1}).power(2)*Polynomial({-13, 1});
+  //times in seconds, distances in feet and speeds in feet per second
+  vector<double> times = {0, 3, 5, 8, 13};
+  vector<double> distances = {0, 225, 383, 623, 993};
+  vector<double> speeds = {75, 77, 80, 74, 72};
 
-  Polynomial speed = distance.derivative();
-  Polynomial b = -80.666666667 + speed; //55 mph = 80.666 ft/s
+  //build the Hermite polynomial from the data with a divided-difference table
+  //everything below works on its nested Newton form, so it is never expanded into powers of t
+  NewtonPolynomial distance;
+  for(size_t i = 0; i < times.size(); i++)
+    distance.addPoint(times[i], distances[i], speeds[i]);
 
-  //find root of b using Newton's method
-  cout << "55 mph reached at t = " << b.root(5) << endl;
-  Polynomial acceleration = speed.derivative();
+  NewtonPolynomial speed = distance.derivative();
+  NewtonPolynomial b = -80.666666667 + speed; //55 mph = 80.666 ft/s
+
+  //the first root of b is the first time the car reaches 55 mph
+  cout << "55 mph reached at t = " << b.realRoots(0, 13).front() << endl;
   //speed has a critical value when acceleration=0
-  double timeOfMaxSpeed = acceleration.root(12);
-  cout << "Max speed of " << speed.evaluate(timeOfMaxSpeed) << " ft/s reached at t = " << timeOfMaxSpeed << endl;
+  Extremum<double> maxSpeed = speed.globalMax(0, 13);
+  cout << "Max speed of " << maxSpeed.value << " ft/s reached at t = " << maxSpeed.x << endl;
 
   return 0;
 }
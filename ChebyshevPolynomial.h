@@ -0,0 +1,243 @@
+//class to represent a polynomial on an interval as a sum of Chebyshev polynomials
+#pragma once
+#include "Polynomial.h"
+#include "Metrics.h"
+#include <vector>
+#include <complex>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <memory_resource>
+#include <stdexcept>
+
+//transforms a in place with an iterative radix-2 fast Fourier transform in O(n log n) time
+//the size of a must be a power of two
+void fft(std::vector<std::complex<double>>& a)
+{
+  size_t n = a.size();
+  //put the entries in bit-reversed order
+  for(size_t i = 1, j = 0; i < n; i++)
+  {
+    size_t bit = n >> 1;
+    for(; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if(i < j)
+      std::swap(a[i], a[j]);
+  }
+
+  for(size_t length = 2; length <= n; length <<= 1)
+  {
+    std::complex<double> step = std::polar(1.0, -2*M_PI/length);
+    for(size_t start = 0; start < n; start += length)
+    {
+      std::complex<double> w = 1;
+      for(size_t k = 0; k < length/2; k++)
+      {
+        std::complex<double> even = a[start+k];
+        std::complex<double> odd = w*a[start+k+length/2];
+        a[start+k] = even + odd;
+        a[start+k+length/2] = even - odd;
+        w *= step;
+      }
+    }
+  }
+}
+
+//returns the n Chebyshev points of the first kind mapped onto [a, b], from b down to a
+//the kth point is the midpoint plus the half-width times cos(pi(k+1/2)/n)
+std::vector<double> chebyshevPoints(int n, double a, double b)
+{
+  std::vector<double> points(n);
+  for(int k = 0; k < n; k++)
+    points[k] = (a+b)/2 + (b-a)/2*std::cos(M_PI*(k+0.5)/n);
+  return points;
+}
+
+//the polynomial is c_0*T_0(u) + c_1*T_1(u) + ... + c_n*T_n(u) where u = (2x-a-b)/(b-a) maps [a, b] onto [-1, 1]
+//the T_k stay between -1 and 1 on the interval, so unlike the monomial form the coefficients
+//stay small and the sum can be evaluated in double even at high degree
+class ChebyshevPolynomial
+{
+  private:
+    std::vector<double> coefficients;
+    double a, b;
+
+    double toUnit(double x) const
+    {
+      return (2*x - a - b)/(b - a);
+    }
+
+  public:
+    //constructs c_0*T_0 + c_1*T_1 + ... on [a, b] where coefficients lists the c_k
+    ChebyshevPolynomial(std::vector<double> coefficients, double a, double b)
+      : coefficients(std::move(coefficients)), a(a), b(b)
+    {
+      if(this->coefficients.empty())
+        this->coefficients.push_back(0);
+    }
+
+    //converts p to Chebyshev form on [a, b] by sampling it at Chebyshev points
+    //p is evaluated in its own type so a LongPolynomial is sampled in long double
+    template <typename T, typename Allocator>
+    ChebyshevPolynomial(const BasicPolynomial<T, Allocator>& p, double a, double b) : a(a), b(b)
+    {
+      int n = 1;
+      while(n <= p.getDegree())
+        n *= 2;
+      std::vector<double> values(n);
+      std::vector<double> points = chebyshevPoints(n, a, b);
+      for(int k = 0; k < n; k++)
+        values[k] = p.evaluate(points[k]);
+      *this = fromValues(values, a, b);
+      coefficients.resize(p.getDegree()+1);
+    }
+
+    //returns the polynomial of degree n-1 through the n values, where values[k] is at the kth point
+    //of chebyshevPoints(n, a, b)
+    //the coefficients are a discrete cosine transform of the values, which takes O(n log n) time
+    //using a fast Fourier transform when n is a power of two and O(n^2) time otherwise
+    static ChebyshevPolynomial fromValues(const std::vector<double>& values, double a, double b)
+    {
+      METRICS_SCOPE("chebyshev.transform");
+      int n = values.size();
+      if(n == 0)
+        throw std::runtime_error("a Chebyshev polynomial needs at least one value");
+
+      //DCT-II: X_k = sum over j of values[j]*cos(pi*k*(j+1/2)/n)
+      std::vector<double> transform(n);
+      if((n & (n-1)) == 0)
+      {
+        //reorder into the evens followed by the reversed odds so one complex FFT of length n gives the DCT
+        std::vector<std::complex<double>> v(n);
+        for(int j = 0; j < (n+1)/2; j++)
+          v[j] = values[2*j];
+        for(int j = 0; j < n/2; j++)
+          v[n-1-j] = values[2*j+1];
+        fft(v);
+        for(int k = 0; k < n; k++)
+          transform[k] = (std::polar(1.0, -M_PI*k/(2*n))*v[k]).real();
+      }
+      else
+      {
+        for(int k = 0; k < n; k++)
+        {
+          for(int j = 0; j < n; j++)
+            transform[k] += values[j]*std::cos(M_PI*k*(j+0.5)/n);
+        }
+      }
+
+      std::vector<double> result(n);
+      result[0] = transform[0]/n;
+      for(int k = 1; k < n; k++)
+        result[k] = 2*transform[k]/n;
+      return ChebyshevPolynomial(result, a, b);
+    }
+
+    double operator[](int k) const
+    {
+      return coefficients[k];
+    }
+
+    int getDegree() const
+    {
+      return coefficients.size()-1;
+    }
+
+    double lower() const
+    {
+      return a;
+    }
+
+    double upper() const
+    {
+      return b;
+    }
+
+    //returns the polynomial evaluated at a specific x value using Clenshaw's recurrence in O(n) time
+    double evaluate(double x) const
+    {
+      double u = toUnit(x);
+      double next = 0;
+      double afterNext = 0;
+      for(int k = getDegree(); k >= 1; k--)
+      {
+        double current = coefficients[k] + 2*u*next - afterNext;
+        afterNext = next;
+        next = current;
+      }
+      return coefficients[0] + u*next - afterNext;
+    }
+
+    //evaluates the polynomial at the n values in xs and stores the results in ys
+    //blocked the same way as BasicPolynomial::evaluate
+    void evaluate(const double* xs, double* ys, size_t n) const
+    {
+      const size_t BLOCK = 64;
+      double u[BLOCK], next[BLOCK], afterNext[BLOCK];
+      for(size_t start = 0; start < n; start += BLOCK)
+      {
+        size_t count = std::min(BLOCK, n - start);
+        for(size_t j = 0; j < count; j++)
+        {
+          u[j] = toUnit(xs[start+j]);
+          next[j] = 0;
+          afterNext[j] = 0;
+        }
+
+        for(int k = getDegree(); k >= 1; k--)
+        {
+          for(size_t j = 0; j < count; j++)
+          {
+            double current = coefficients[k] + 2*u[j]*next[j] - afterNext[j];
+            afterNext[j] = next[j];
+            next[j] = current;
+          }
+        }
+
+        for(size_t j = 0; j < count; j++)
+          ys[start+j] = coefficients[0] + u[j]*next[j] - afterNext[j];
+      }
+    }
+
+    //returns the derivative, which is also in Chebyshev form on [a, b]
+    //it uses c'_{k-1} = c'_{k+1} + 2k*c_k, scaled by du/dx = 2/(b-a)
+    ChebyshevPolynomial derivative() const
+    {
+      int n = getDegree();
+      if(n == 0)
+        return ChebyshevPolynomial({0}, a, b);
+      //result[n] and result[n+1] stay 0 to start the recurrence
+      std::vector<double> result(n+2, 0.0);
+      for(int k = n; k >= 1; k--)
+        result[k-1] = result[k+1] + 2*k*coefficients[k];
+      result[0] /= 2;
+      result.resize(n);
+      for(auto& c : result)
+        c *= 2/(b - a);
+      return ChebyshevPolynomial(result, a, b);
+    }
+
+    //expands the polynomial into powers of x in O(n^2) time using Clenshaw's recurrence on polynomials
+    //the monomial form of a high degree polynomial is fragile, so the expansion is done in long double
+    //and T only sets the result's type
+    //the recurrence makes a few temporaries per coefficient, so they are all taken from one arena
+    template <typename T = double>
+    BasicPolynomial<T> toPolynomial() const
+    {
+      std::pmr::monotonic_buffer_resource arena;
+      //u = (2x-a-b)/(b-a) as a polynomial in x
+      LongArenaPolynomial u({(long double)(-(a+b)/(b-a)), (long double)(2/(b-a))}, &arena);
+      LongArenaPolynomial next(&arena);
+      LongArenaPolynomial afterNext(&arena);
+      for(int k = getDegree(); k >= 1; k--)
+      {
+        LongArenaPolynomial current = (long double)coefficients[k] + (long double)2*u*next - afterNext;
+        afterNext = std::move(next);
+        next = std::move(current);
+      }
+      LongArenaPolynomial result = (long double)coefficients[0] + u*next - afterNext;
+      const auto& expanded = result.getCoefficients();
+      return BasicPolynomial<T>(std::vector<T>(expanded.begin(), expanded.end()));
+    }
+};
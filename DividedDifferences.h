@@ -0,0 +1,238 @@
+//class to represent an interpolating polynomial in Newton form built from a divided-difference table
+#pragma once
+#include "Polynomial.h"
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <functional>
+
+//the polynomial is c_0 + c_1(x-z_0) + c_2(x-z_0)(x-z_1) + ... + c_{n-1}(x-z_0)...(x-z_{n-2})
+//where the z_k are the nodes and c_k = f[z_0, ..., z_k] are the divided differences
+//Hermite data lists each x-value twice in a row as a node, and the derivative stands in for
+//the divided difference f[x, x] that would otherwise divide by zero
+class NewtonPolynomial
+{
+  private:
+    std::vector<double> nodes;
+    std::vector<double> coefficients;
+    //the bottom row of the divided-difference table: lastRow[j] = f[z_{n-1-j}, ..., z_{n-1}]
+    //it is all that is needed to add another row, so adding a node takes O(n) time
+    std::vector<double> lastRow;
+
+    //adds the node z with f(z) = y, using dy for the divided difference over a repeated node
+    void addNode(double z, double y, double dy)
+    {
+      int n = nodes.size();
+      //only a node repeated right away for Hermite data may match an existing node
+      for(int k = 0; k < n; k++)
+      {
+        if(nodes[k] == z && (k != n-1 || std::isnan(dy)))
+          throw std::runtime_error("the node " + std::to_string(z) + " is repeated without a derivative");
+      }
+
+      //the new bottom row is built over the old one from left to right
+      //keeping the entry it replaces for the next divided difference
+      double replaced = n > 0 ? lastRow[0] : 0;
+      lastRow.resize(n+1);
+      lastRow[0] = y;
+      for(int j = 1; j <= n; j++)
+      {
+        double old = lastRow[j];
+        double width = z - nodes[n-j];
+        lastRow[j] = width == 0 ? dy : (lastRow[j-1] - replaced)/width;
+        replaced = old;
+      }
+
+      nodes.push_back(z);
+      coefficients.push_back(lastRow[n]);
+    }
+
+    //returns how far from 0 the rounding error of the nested form can put the polynomial evaluated at x
+    double roundingBound(double x) const
+    {
+      double bound = std::fabs(coefficients.back());
+      for(int k = size()-2; k >= 0; k--)
+        bound = bound*std::fabs(x - nodes[k]) + std::fabs(coefficients[k]);
+      return 4*size()*std::numeric_limits<double>::epsilon()*bound;
+    }
+
+  public:
+    //creates the polynomial 0 with no nodes
+    NewtonPolynomial()
+    {
+    }
+
+    //builds the divided-difference table of points in O(n^2) time
+    //the x-values of points must be distinct
+    NewtonPolynomial(const std::vector<std::pair<double, double>>& points)
+    {
+      nodes.reserve(points.size());
+      coefficients.reserve(points.size());
+      for(auto point : points)
+        addPoint(point.first, point.second);
+    }
+
+    //adds the point (x, y) in O(n) time
+    //throws std::runtime_error if x is already a node
+    void addPoint(double x, double y)
+    {
+      addNode(x, y, NAN);
+    }
+
+    //adds the point (x, y) where the derivative is dy, as for Hermite interpolation, in O(n) time
+    //throws std::runtime_error if x is already a node
+    void addPoint(double x, double y, double dy)
+    {
+      addNode(x, y, NAN);
+      addNode(x, y, dy);
+    }
+
+    //returns how many nodes there are, counting a Hermite point twice
+    int size() const
+    {
+      return nodes.size();
+    }
+
+    //returns z_k
+    double getNode(int k) const
+    {
+      return nodes[k];
+    }
+
+    //returns c_k = f[z_0, ..., z_k]
+    double getCoefficient(int k) const
+    {
+      return coefficients[k];
+    }
+
+    //returns the degree, which is less than size()-1 when the last divided differences are 0
+    int getDegree() const
+    {
+      int degree = size()-1;
+      while(degree > 0 && coefficients[degree] == 0)
+        degree--;
+      return std::max(degree, 0);
+    }
+
+    //adds constant to the polynomial in O(1) time
+    //only c_0 and f(z_{n-1}) change, since a constant cancels out of every higher divided difference
+    NewtonPolynomial& operator+=(double constant)
+    {
+      if(coefficients.empty())
+        addPoint(0, 0);
+      coefficients[0] += constant;
+      lastRow[0] += constant;
+      return *this;
+    }
+
+    //returns the polynomial evaluated at a specific x value in O(n) time
+    //using the nested form c_0 + (x-z_0)(c_1 + (x-z_1)(c_2 + ...))
+    double evaluate(double x) const
+    {
+      if(coefficients.empty())
+        return 0;
+      double result = coefficients.back();
+      for(int k = size()-2; k >= 0; k--)
+        result = result*(x - nodes[k]) + coefficients[k];
+      return result;
+    }
+
+    //returns the polynomial and its first and second derivatives at x in one pass over the nested form
+    Derivatives<double> evaluateDerivatives(double x) const
+    {
+      if(coefficients.empty())
+        return {0, 0, 0};
+      double value = coefficients.back();
+      double first = 0;
+      double second = 0;
+      for(int k = size()-2; k >= 0; k--)
+      {
+        double t = x - nodes[k];
+        second = second*t + first;
+        first = first*t + value;
+        value = value*t + coefficients[k];
+      }
+      //the recurrence builds p''(x)/2
+      return {value, first, 2*second};
+    }
+
+    //returns the derivative in Newton form in O(n^2) time without expanding into powers of x
+    //the derivative has degree n-2, so it is the polynomial through the derivative's values at
+    //z_0, ..., z_{n-2}, and at a repeated Hermite node the second derivative is the divided difference
+    //both come from evaluateDerivatives on the nested form
+    NewtonPolynomial derivative() const
+    {
+      NewtonPolynomial result;
+      for(int k = 0; k+1 < size(); k++)
+      {
+        Derivatives<double> f = evaluateDerivatives(nodes[k]);
+        bool repeated = k > 0 && nodes[k] == nodes[k-1];
+        result.addNode(nodes[k], f.first, repeated ? f.second : NAN);
+      }
+      return result;
+    }
+
+    //returns every real root in [lo, hi] in increasing order without needing an initial guess
+    //findRealRoots does the same search as for BasicPolynomial on the nested form,
+    //so the polynomial is never expanded into powers of x
+    //the zero polynomial has no isolated roots so it returns none
+    std::vector<double> realRoots(double lo, double hi) const
+    {
+      int degree = getDegree();
+      if(coefficients.empty() || degree == 0)
+        return std::vector<double>();
+      if(degree == 1)
+      {
+        //c_0 + c_1(x - z_0) = 0
+        std::vector<double> roots;
+        double r = nodes[0] - coefficients[0]/coefficients[1];
+        if(r >= lo && r <= hi)
+          roots.push_back(r);
+        return roots;
+      }
+      return findRealRoots(*this, lo, hi, [this](double x) { return roundingBound(x); });
+    }
+
+    //returns where the polynomial is largest on [lo, hi] and its value there
+    Extremum<double> globalMax(double lo, double hi) const
+    {
+      return findExtremum(*this, lo, hi, std::greater<double>());
+    }
+
+    //returns where the polynomial is smallest on [lo, hi] and its value there
+    Extremum<double> globalMin(double lo, double hi) const
+    {
+      return findExtremum(*this, lo, hi, std::less<double>());
+    }
+
+    //expands the polynomial into powers of x in O(n^2) time by multiplying out the nested form
+    //one linear factor at a time
+    //only needed when the monomial form itself is wanted, everything above works on the nested form
+    Polynomial toPolynomial() const
+    {
+      if(coefficients.empty())
+        return Polynomial({0});
+      std::vector<double> result = {coefficients.back()};
+      for(int k = size()-2; k >= 0; k--)
+      {
+        //result = result*(x - z_k) + c_k
+        result.push_back(0);
+        for(int j = result.size()-1; j > 0; j--)
+          result[j] = result[j-1] - nodes[k]*result[j];
+        result[0] = -nodes[k]*result[0] + coefficients[k];
+      }
+      return Polynomial(result);
+    }
+};
+
+//returns p plus constant
+NewtonPolynomial operator+(double constant, NewtonPolynomial p)
+{
+  p += constant;
+  return p;
+}
@@ -0,0 +1,142 @@
+//class to represent a polynomial of degree at most N with the coefficients stored inline
+#pragma once
+#include "Polynomial.h"
+#include <array>
+#include <vector>
+#include <cassert>
+#include <ostream>
+
+template <int N, typename T = double>
+class FixedPolynomial
+{
+  private:
+    //coefficients listed from lowest to highest degree, unused ones are 0
+    std::array<T, N+1> coefficients;
+
+  public:
+    typedef T value_type;
+
+    //default constructor creates the polynomial 0x^0
+    constexpr FixedPolynomial() : coefficients{}
+    {
+    }
+
+    //constructs a polynomial where args are the coefficients listed from lowest to highest degree
+    //any coefficients not given are 0 and there can be at most N+1 of them
+    constexpr FixedPolynomial(std::initializer_list<T> args) : coefficients{}
+    {
+      assert(args.size() <= N+1);
+      int i = 0;
+      for(T arg : args)
+      {
+        coefficients[i++] = arg;
+      }
+    }
+
+    //converts a Polynomial whose degree is at most N
+    template <typename U, typename Allocator>
+    explicit FixedPolynomial(const BasicPolynomial<U, Allocator>& p) : coefficients{}
+    {
+      assert(p.getDegree() <= N);
+      for(int i = 0; i <= p.getDegree() && i <= N; i++)
+      {
+        coefficients[i] = p[i];
+      }
+    }
+
+    constexpr T operator[](int i) const
+    {
+      return coefficients[i];
+    }
+
+    constexpr T& operator[](int i)
+    {
+      return coefficients[i];
+    }
+
+    //returns the largest degree this polynomial can have
+    static constexpr int getMaxDegree()
+    {
+      return N;
+    }
+
+    //returns the polynomial evaluated at a specific x value using Horner's method
+    //N is known at compile time so the loop is fully unrolled
+    constexpr T evaluate(T x) const
+    {
+      T result = coefficients[N];
+      for(int i = N-1; i >= 0; i--)
+      {
+        result = result*x + coefficients[i];
+      }
+      return result;
+    }
+
+    constexpr FixedPolynomial<(N > 0 ? N-1 : 0), T> derivative() const
+    {
+      FixedPolynomial<(N > 0 ? N-1 : 0), T> result;
+      for(int i = 1; i <= N; i++)
+      {
+        result[i-1] = i*coefficients[i];
+      }
+      return result;
+    }
+
+    //converts to a heap-backed Polynomial
+    BasicPolynomial<T> toPolynomial() const
+    {
+      return BasicPolynomial<T>(std::vector<T>(coefficients.begin(), coefficients.end()));
+    }
+};
+
+template <int N, typename T>
+constexpr FixedPolynomial<N, T> operator+(FixedPolynomial<N, T> a, const FixedPolynomial<N, T>& b)
+{
+  for(int i = 0; i <= N; i++)
+  {
+    a[i] += b[i];
+  }
+  return a;
+}
+
+template <int N, typename T>
+constexpr FixedPolynomial<N, T> operator-(FixedPolynomial<N, T> a, const FixedPolynomial<N, T>& b)
+{
+  for(int i = 0; i <= N; i++)
+  {
+    a[i] -= b[i];
+  }
+  return a;
+}
+
+//T is only deduced from p so that a scalar such as an int literal is converted to T
+template <int N, typename T>
+constexpr FixedPolynomial<N, T> operator*(typename FixedPolynomial<N, T>::value_type scalar, FixedPolynomial<N, T> p)
+{
+  for(int i = 0; i <= N; i++)
+  {
+    p[i] *= scalar;
+  }
+  return p;
+}
+
+//the degree of a product is the sum of the degrees
+template <int N, int M, typename T>
+constexpr FixedPolynomial<N+M, T> operator*(const FixedPolynomial<N, T>& a, const FixedPolynomial<M, T>& b)
+{
+  FixedPolynomial<N+M, T> result;
+  for(int i = 0; i <= N; i++)
+  {
+    for(int j = 0; j <= M; j++)
+    {
+      result[i+j] += a[i]*b[j];
+    }
+  }
+  return result;
+}
+
+template <int N, typename T>
+std::ostream& operator<<(std::ostream& os, const FixedPolynomial<N, T>& p)
+{
+  return os << p.toPolynomial();
+}
@@ -0,0 +1,126 @@
+//class to represent a natural cubic spline that grows one point at a time
+#pragma once
+#include "Spline.h"
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+//in the natural spline system a change to one c_i is at most half as big in c_{i-1},
+//since 2(h_{i-1}+h_i) is more than twice h_{i-1}, so a new point changes the c_i more
+//than this many knots back by less than 2^-64 of its effect on the end
+//the constants are exact to rounding even though only the ones near the changed end are solved again
+const int INCREMENTAL_SPLINE_TAIL = 64;
+
+//the spline is S_i(x) = a_i + b_i(x-x_i) + c_i(x-x_i)^2 + d_i(x-x_i)^3 like CubicSpline,
+//but only the knots, the y-values and the c_i constants are stored since a_i, b_i and d_i follow from them
+//appending a point takes O(1) time instead of refitting the whole spline
+class IncrementalSpline
+{
+  private:
+    std::deque<double> x;
+    std::deque<double> y;
+    std::deque<double> c;
+    //the most points kept at once, or 0 to keep every point
+    size_t window;
+    //scratch space for the tridiagonal solves so appending doesn't allocate
+    std::vector<double> sub, diag, super, alpha;
+
+    //solves the natural spline system again for c_first ... c_last
+    //with the c_i just outside that range held at their current values
+    void solveRange(int first, int last)
+    {
+      int m = last - first + 1;
+      sub.resize(m);
+      diag.resize(m);
+      super.resize(m);
+      alpha.resize(m);
+      for(int k = 0; k < m; k++)
+      {
+        int i = first + k;
+        double before = x[i] - x[i-1];
+        double after = x[i+1] - x[i];
+        sub[k] = before;
+        diag[k] = 2*(before + after);
+        super[k] = after;
+        alpha[k] = 3/after*(y[i+1] - y[i]) - 3/before*(y[i] - y[i-1]);
+      }
+      alpha[0] -= sub[0]*c[first-1];
+      alpha[m-1] -= super[m-1]*c[last+1];
+
+      solveTridiagonal(sub, diag, super, alpha);
+      std::copy(alpha.begin(), alpha.end(), c.begin() + first);
+    }
+
+  public:
+    //creates an empty spline that keeps every point, or only the last window points if window isn't 0
+    //throws std::runtime_error if window is 1 since a spline needs at least two points
+    explicit IncrementalSpline(size_t window = 0) : window(window)
+    {
+      if(window == 1)
+        throw std::runtime_error("a sliding window needs room for at least two points");
+    }
+
+    //adds the point (newX, newY) to the right end of the spline
+    //in a sliding window the oldest point is dropped once the window is full
+    //throws std::runtime_error if newX isn't larger than every x-value so far
+    void append(double newX, double newY)
+    {
+      if(!x.empty() && newX <= x.back())
+        throw std::runtime_error("points must be appended in increasing order of x");
+
+      //the new point takes over the natural boundary condition c_n = 0 from the old end
+      x.push_back(newX);
+      y.push_back(newY);
+      c.push_back(0);
+      int n = size();
+      if(n >= 2)
+        solveRange(std::max(1, n - INCREMENTAL_SPLINE_TAIL), n-1);
+
+      if(window != 0 && x.size() > window)
+      {
+        //the new first point takes over the boundary condition c_0 = 0
+        x.pop_front();
+        y.pop_front();
+        c.pop_front();
+        c.front() = 0;
+        n = size();
+        if(n >= 2)
+          solveRange(1, std::min(INCREMENTAL_SPLINE_TAIL, n-1));
+      }
+    }
+
+    //returns how many cubics make up the spline
+    int size() const
+    {
+      return std::max<int>(0, x.size()-1);
+    }
+
+    //returns x_i
+    double getKnot(int i) const
+    {
+      return x[i];
+    }
+
+    //returns the spline evaluated at a specific x value
+    //x-values outside the knots use the first or last cubic
+    //the spline needs at least two points
+    double evaluate(double t) const
+    {
+      int i = std::upper_bound(x.begin()+1, x.end()-1, t) - (x.begin()+1);
+      double h = x[i+1] - x[i];
+      FixedPolynomial<3> cubic = {y[i], (y[i+1] - y[i])/h - h*(c[i+1]+2*c[i])/3, c[i], (c[i+1]-c[i])/(3*h)};
+      return cubic.evaluate(t - x[i]);
+    }
+
+    //returns the spline as a CubicSpline in O(n) time
+    //the spline needs at least two points
+    CubicSpline toSpline() const
+    {
+      std::vector<double> knots(x.begin(), x.end());
+      std::vector<double> values(y.begin(), y.end());
+      std::vector<double> constants(c.begin(), c.end());
+      return buildSpline(knots, values.data(), constants);
+    }
+};
@@ -0,0 +1,179 @@
+//class to represent a Lagrange interpolating polynomial in barycentric form
+#pragma once
+#include "Polynomial.h"
+#include "ChebyshevPolynomial.h"
+#include "Metrics.h"
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+class BarycentricInterpolator
+{
+  private:
+    std::vector<double> x;
+    std::vector<double> y;
+    //w[k] = 1/((x_k-x_0)...(x_k-x_{k-1})(x_k-x_{k+1})...(x_k-x_n))
+    std::vector<double> weights;
+
+    //computes the barycentric weights in O(n^2) time
+    void computeWeights()
+    {
+      METRICS_SCOPE("lagrange.weights");
+      int n = x.size();
+      weights.assign(n, 1.0);
+      for(int k = 0; k < n; k++)
+      {
+        for(int i = 0; i < n; i++)
+        {
+          if(i != k)
+            weights[k] *= x[k] - x[i];
+        }
+        weights[k] = 1/weights[k];
+      }
+    }
+
+  public:
+    //precomputes the barycentric weights of points in O(n^2) time
+    //the x-values of points must be distinct
+    BarycentricInterpolator(const std::vector<std::pair<double, double>>& points)
+    {
+      x.reserve(points.size());
+      y.reserve(points.size());
+      for(auto point : points)
+      {
+        x.push_back(point.first);
+        y.push_back(point.second);
+      }
+      computeWeights();
+    }
+
+    //precomputes the barycentric weights of the points (x[i], y[i]) in O(n^2) time
+    //the x-values must be distinct
+    BarycentricInterpolator(std::vector<double> x, std::vector<double> y)
+      : x(std::move(x)), y(std::move(y))
+    {
+      computeWeights();
+    }
+
+    //returns the interpolating polynomial evaluated at t in O(n) time
+    double evaluate(double t) const
+    {
+      double numerator = 0;
+      double denominator = 0;
+      for(size_t k = 0; k < x.size(); k++)
+      {
+        //the formula divides by zero at a node, where the answer is just the data
+        if(t == x[k])
+          return y[k];
+        double term = weights[k]/(t - x[k]);
+        numerator += term*y[k];
+        denominator += term;
+      }
+      return numerator/denominator;
+    }
+
+    //evaluates the interpolating polynomial at the n values in ts and stores the results in ys
+    //blocked the same way as BasicPolynomial::evaluate
+    void evaluate(const double* ts, double* ys, size_t n) const
+    {
+      const size_t BLOCK = 64;
+      double numerator[BLOCK];
+      double denominator[BLOCK];
+      for(size_t start = 0; start < n; start += BLOCK)
+      {
+        size_t count = std::min(BLOCK, n - start);
+        for(size_t j = 0; j < count; j++)
+        {
+          numerator[j] = 0;
+          denominator[j] = 0;
+        }
+
+        for(size_t k = 0; k < x.size(); k++)
+        {
+          for(size_t j = 0; j < count; j++)
+          {
+            double term = weights[k]/(ts[start+j] - x[k]);
+            numerator[j] += term*y[k];
+            denominator[j] += term;
+          }
+        }
+
+        for(size_t j = 0; j < count; j++)
+        {
+          ys[start+j] = numerator[j]/denominator[j];
+          //a point that landed exactly on a node divided by zero, so redo it the slow way
+          if(!std::isfinite(ys[start+j]))
+            ys[start+j] = evaluate(ts[start+j]);
+        }
+      }
+    }
+
+    //expands the interpolating polynomial into a Polynomial in O(n^2) time
+    //this is the only place the numerically fragile monomial form is built
+    //the expansion is always done in long double and T only sets the result's type
+    template <typename T = double>
+    BasicPolynomial<T> toPolynomial() const
+    {
+      METRICS_SCOPE("lagrange.toPolynomial");
+      int n = x.size();
+
+      //l(x) = (x-x_0)(x-x_1)...(x-x_{n-1}) with coefficients from lowest to highest degree
+      std::vector<long double> l(n+1, 0.0);
+      l[0] = 1;
+      for(int i = 0; i < n; i++)
+      {
+        for(int j = i+1; j > 0; j--)
+          l[j] = l[j-1] - x[i]*l[j];
+        l[0] = -x[i]*l[0];
+      }
+
+      //the kth Lagrange basis polynomial is w_k*l(x)/(x-x_k)
+      //which is found by synthetic division of l(x) by (x-x_k)
+      std::vector<long double> resultCoefficients(n, 0.0);
+      std::vector<long double> quotient(n);
+      for(int k = 0; k < n; k++)
+      {
+        quotient[n-1] = l[n];
+        for(int j = n-1; j > 0; j--)
+          quotient[j-1] = l[j] + x[k]*quotient[j];
+
+        long double scale = weights[k]*y[k];
+        for(int j = 0; j < n; j++)
+          resultCoefficients[j] += scale*quotient[j];
+      }
+      return BasicPolynomial<T>(std::vector<T>(resultCoefficients.begin(), resultCoefficients.end()));
+    }
+
+    //converts the interpolating polynomial to Chebyshev form on the interval the x-values cover
+    //it is sampled at the next power of two Chebyshev points at or above the number of points
+    //so the transform is a fast one, which takes O(n^2) time for the samples and O(n log n) for the transform
+    ChebyshevPolynomial toChebyshev() const
+    {
+      METRICS_SCOPE("lagrange.toChebyshev");
+      int n = x.size();
+      double a = *std::min_element(x.begin(), x.end());
+      double b = *std::max_element(x.begin(), x.end());
+      int samples = 1;
+      while(samples < n)
+        samples *= 2;
+
+      std::vector<double> points = chebyshevPoints(samples, a, b);
+      std::vector<double> values(samples);
+      evaluate(points.data(), values.data(), samples);
+      ChebyshevPolynomial sampled = ChebyshevPolynomial::fromValues(values, a, b);
+
+      //the interpolating polynomial has degree n-1 so the higher coefficients are only rounding
+      std::vector<double> coefficients(n);
+      for(int k = 0; k < n; k++)
+        coefficients[k] = sampled[k];
+      return ChebyshevPolynomial(coefficients, a, b);
+    }
+};
+
+//constructs a Lagrange Interpolating Polynomial from points
+Polynomial lagrange(const std::vector<std::pair<double, double>>& points)
+{
+  return BarycentricInterpolator(points).toPolynomial();
+}
@@ -0,0 +1,193 @@
+//counters and scoped timers to see where the work goes, compiled in only when INTERP_METRICS is defined
+#pragma once
+#include <ostream>
+
+//compile with -DINTERP_METRICS to turn the metrics on
+//without it METRICS_COUNT and METRICS_SCOPE expand to nothing and the output functions
+//write empty results, so instrumented code costs nothing
+//
+//METRICS_COUNT(name, amount) adds amount to the counter called name
+//METRICS_SCOPE(name) times the rest of the enclosing block as a stage called name
+//name must be a string literal
+//
+//each thread counts and times into its own records, so recording never takes a lock,
+//and the records of every thread are combined when they are written out
+
+#ifdef INTERP_METRICS
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <iomanip>
+
+namespace metrics
+{
+  //one finished timed scope
+  struct Event
+  {
+    const char* name;
+    long long start;
+    long long duration;
+  };
+
+  //the counters and events recorded by one thread
+  struct ThreadRecord
+  {
+    int id;
+    //keyed by the address of the name, which is cheaper than comparing strings
+    std::map<const char*, long long> counters;
+    std::vector<Event> events;
+  };
+
+  //every thread's records, which outlive the threads so they can be written after the threads finish
+  std::mutex registryLock;
+  std::vector<std::shared_ptr<ThreadRecord>> registry;
+  const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+  //returns the nanoseconds since the program started
+  long long now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+  }
+
+  //returns the calling thread's records, registering them the first time
+  ThreadRecord& local()
+  {
+    thread_local std::shared_ptr<ThreadRecord> record = []()
+    {
+      auto created = std::make_shared<ThreadRecord>();
+      std::lock_guard<std::mutex> guard(registryLock);
+      created->id = registry.size();
+      registry.push_back(created);
+      return created;
+    }();
+    return *record;
+  }
+
+  void count(const char* name, long long amount)
+  {
+    local().counters[name] += amount;
+  }
+
+  //times from construction to destruction
+  class ScopedTimer
+  {
+    private:
+      const char* name;
+      long long start;
+
+    public:
+      explicit ScopedTimer(const char* name) : name(name), start(now())
+      {
+      }
+
+      ScopedTimer(const ScopedTimer&) = delete;
+      ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+      ~ScopedTimer()
+      {
+        local().events.push_back({name, start, now() - start});
+      }
+  };
+
+  //the totals over every thread, with names compared as strings
+  struct Totals
+  {
+    std::map<std::string, long long> counters;
+    //each timer's number of scopes and total nanoseconds
+    std::map<std::string, std::pair<long long, long long>> timers;
+  };
+
+  //adds up every thread's records
+  //the other threads should be done recording when this is called
+  Totals totals()
+  {
+    Totals result;
+    std::lock_guard<std::mutex> guard(registryLock);
+    for(auto& record : registry)
+    {
+      for(auto& counter : record->counters)
+        result.counters[counter.first] += counter.second;
+      for(Event& event : record->events)
+      {
+        auto& timer = result.timers[event.name];
+        timer.first++;
+        timer.second += event.duration;
+      }
+    }
+    return result;
+  }
+}
+
+#define METRICS_JOIN_NAME(a, b) a##b
+#define METRICS_TIMER_NAME(line) METRICS_JOIN_NAME(metricsTimer, line)
+#define METRICS_COUNT(name, amount) metrics::count(name, amount)
+#define METRICS_SCOPE(name) metrics::ScopedTimer METRICS_TIMER_NAME(__LINE__)(name)
+
+//writes every counter and the number of times and total time of every timer as JSON
+void writeMetricsJson(std::ostream& os)
+{
+  metrics::Totals all = metrics::totals();
+  os << "{\n  \"counters\": {";
+  bool first = true;
+  for(auto& counter : all.counters)
+  {
+    os << (first ? "\n" : ",\n") << "    \"" << counter.first << "\": " << counter.second;
+    first = false;
+  }
+  os << "\n  },\n  \"timers\": {";
+  first = true;
+  for(auto& timer : all.timers)
+  {
+    os << (first ? "\n" : ",\n") << "    \"" << timer.first << "\": {\"count\": " << timer.second.first
+       << ", \"total_ns\": " << timer.second.second << "}";
+    first = false;
+  }
+  os << "\n  }\n}\n";
+}
+
+//writes every timed scope in the Chrome trace event format, which chrome://tracing and Perfetto can open
+//each thread that recorded anything is its own row
+void writeChromeTrace(std::ostream& os)
+{
+  std::lock_guard<std::mutex> guard(metrics::registryLock);
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+  os << "{\"traceEvents\": [";
+  bool first = true;
+  for(auto& record : metrics::registry)
+  {
+    for(metrics::Event& event : record->events)
+    {
+      //trace times are in microseconds
+      os << (first ? "\n" : ",\n") << "  {\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 0"
+         << ", \"tid\": " << record->id << ", \"ts\": " << event.start/1000.0 << ", \"dur\": " << event.duration/1000.0 << "}";
+      first = false;
+    }
+  }
+  os << "\n]}\n";
+  os.flags(flags);
+  os.precision(precision);
+}
+
+#else
+
+#define METRICS_COUNT(name, amount) ((void)0)
+#define METRICS_SCOPE(name) ((void)0)
+
+void writeMetricsJson(std::ostream& os)
+{
+  os << "{\n  \"counters\": {},\n  \"timers\": {}\n}\n";
+}
+
+void writeChromeTrace(std::ostream& os)
+{
+  os << "{\"traceEvents\": []}\n";
+}
+
+#endif
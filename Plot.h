@@ -0,0 +1,239 @@
+//classes to plot curves with gnuplot by sampling them natively and streaming the samples as binary data
+#pragma once
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <signal.h>
+#include <pthread.h>
+#include <cstddef>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+
+//a plot is built up from gnuplot settings and a list of series
+//curves are evaluated here on a grid with their batch evaluate, so gnuplot only draws line segments
+//and the time to render depends on the number of samples and not on how the curve is represented
+class Plot
+{
+  private:
+    struct Series
+    {
+      //x and y of each sample interleaved, empty for a series read from a file
+      std::vector<double> xy;
+      //the name of a data file gnuplot reads itself, empty for sampled data
+      std::string fileName;
+      std::string options;
+    };
+
+    std::vector<std::string> settings;
+    std::vector<Series> series;
+
+  public:
+    //adds a gnuplot command, such as "set xrange [0:30]", to run before plotting
+    void set(const std::string& setting)
+    {
+      settings.push_back(setting);
+    }
+
+    //samples curve at the given number of evenly spaced x-values in [a, b]
+    //curve is anything with a batch evaluate(const double* xs, double* ys, size_t n),
+    //such as a CubicSplineView, a ChebyshevPolynomial or a Polynomial
+    //options are gnuplot plot options such as "title 'spline' with lines"
+    template <typename Curve>
+    void addCurve(const Curve& curve, double a, double b, int samples, const std::string& options)
+    {
+      std::vector<double> xs(samples), ys(samples);
+      for(int i = 0; i < samples; i++)
+        xs[i] = samples > 1 ? a + (b - a)*i/(samples-1) : a;
+      curve.evaluate(xs.data(), ys.data(), samples);
+      addPoints(xs, ys, options);
+    }
+
+    //adds the points (x[i], y[i])
+    void addPoints(const std::vector<double>& x, const std::vector<double>& y, const std::string& options)
+    {
+      Series added;
+      added.xy.resize(2*x.size());
+      for(size_t i = 0; i < x.size(); i++)
+      {
+        added.xy[2*i] = x[i];
+        added.xy[2*i+1] = y[i];
+      }
+      added.options = options;
+      series.push_back(std::move(added));
+    }
+
+    //adds the data in fileName, which gnuplot reads itself
+    void addFile(const std::string& fileName, const std::string& options)
+    {
+      Series added;
+      added.fileName = fileName;
+      added.options = options;
+      series.push_back(std::move(added));
+    }
+
+    //writes the commands and then the samples of each sampled series as raw doubles
+    //gnuplot reads each '-' binary series from the stream right after the plot command
+    void write(std::FILE* gnuplot) const
+    {
+      std::stringstream commands;
+      commands.precision(17);
+      for(const std::string& setting : settings)
+        commands << setting << "\n";
+
+      commands << "plot ";
+      for(size_t i = 0; i < series.size(); i++)
+      {
+        if(i > 0)
+          commands << ", ";
+        if(series[i].fileName.empty())
+          commands << "'-' binary record=(" << series[i].xy.size()/2 << ") format='%float64%float64' using 1:2 ";
+        else
+          commands << "'" << series[i].fileName << "' ";
+        commands << series[i].options;
+      }
+      commands << "\n";
+
+      std::string text = commands.str();
+      std::fwrite(text.data(), 1, text.size(), gnuplot);
+      for(const Series& s : series)
+      {
+        if(s.fileName.empty())
+          std::fwrite(s.xy.data(), sizeof(double), s.xy.size(), gnuplot);
+      }
+      std::fflush(gnuplot);
+    }
+};
+
+//class to keep one gnuplot process running and render plots on it in the background
+//plots are queued by submit and written to gnuplot's input by a worker thread, so the caller can keep
+//working while they render, and nothing is written to disk except the plots' own output files
+//every write to gnuplot happens on the worker thread, which blocks SIGPIPE, so a gnuplot that exits
+//early makes the writes fail instead of ending the program, and no process-wide signal handler changes
+class GnuplotSession
+{
+  private:
+    std::FILE* gnuplot;
+    std::deque<Plot> jobs;
+    //true while the worker is writing a plot it has taken off the queue
+    bool writing;
+    bool stopping;
+    bool failed;
+    std::mutex lock;
+    std::condition_variable changed;
+    std::thread worker;
+
+    void work()
+    {
+      //a SIGPIPE raised by a write on this thread stays pending here and is dropped when the thread ends
+      sigset_t pipeSignal;
+      sigemptyset(&pipeSignal);
+      sigaddset(&pipeSignal, SIGPIPE);
+      pthread_sigmask(SIG_BLOCK, &pipeSignal, nullptr);
+
+      std::unique_lock<std::mutex> guard(lock);
+      while(true)
+      {
+        changed.wait(guard, [&]() { return stopping || !jobs.empty(); });
+        if(jobs.empty())
+          break;
+
+        Plot plot = std::move(jobs.front());
+        jobs.pop_front();
+        writing = true;
+        guard.unlock();
+
+        //each plot starts from gnuplot's defaults and closes its output file when it is done
+        std::fputs("reset\n", gnuplot);
+        plot.write(gnuplot);
+        std::fputs("unset output\n", gnuplot);
+        std::fflush(gnuplot);
+        bool error = std::ferror(gnuplot);
+
+        guard.lock();
+        writing = false;
+        failed = failed || error;
+        changed.notify_all();
+      }
+      guard.unlock();
+
+      //closing flushes whatever is still buffered, so it is a write too and belongs on this thread
+      int status = pclose(gnuplot);
+      guard.lock();
+      failed = failed || status != 0;
+    }
+
+  public:
+    //starts gnuplot and the worker thread that feeds it
+    GnuplotSession() : writing(false), stopping(false), failed(false)
+    {
+      gnuplot = popen("gnuplot", "w");
+      if(gnuplot == nullptr)
+        throw std::runtime_error("could not start gnuplot");
+      worker = std::thread(&GnuplotSession::work, this);
+    }
+
+    GnuplotSession(const GnuplotSession&) = delete;
+    GnuplotSession& operator=(const GnuplotSession&) = delete;
+
+    ~GnuplotSession()
+    {
+      finish();
+    }
+
+    //queues plot to be rendered and returns right away
+    //throws std::runtime_error once finish has been called, since no plot would be rendered after that
+    void submit(Plot plot)
+    {
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        if(stopping)
+          throw std::runtime_error("the gnuplot session is already finished");
+        jobs.push_back(std::move(plot));
+      }
+      changed.notify_all();
+    }
+
+    //blocks until every plot submitted so far has been sent to gnuplot
+    void wait()
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      changed.wait(guard, [&]() { return jobs.empty() && !writing; });
+    }
+
+    //sends every queued plot, then closes gnuplot and waits for it to finish drawing
+    //returns false if gnuplot couldn't be run or reported an error
+    //the session can't be used after this
+    bool finish()
+    {
+      if(gnuplot == nullptr)
+        return !failed;
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+      }
+      changed.notify_all();
+      worker.join();
+      gnuplot = nullptr;
+      return !failed;
+    }
+};
+
+//renders plot on a session of its own and waits for it
+//returns false if gnuplot couldn't be run or reported an error
+bool renderPlot(const Plot& plot)
+{
+  try
+  {
+    GnuplotSession session;
+    session.submit(plot);
+    return session.finish();
+  }
+  catch(const std::runtime_error&)
+  {
+    return false;
+  }
+}
@@ -0,0 +1,248 @@
+//functions to load (x, y) data points from text files and get them ready for fitting
+#pragma once
+#include <vector>
+#include <string>
+#include <thread>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//data points with the x-values and y-values in separate arrays
+struct PointData
+{
+  std::vector<double> x;
+  std::vector<double> y;
+};
+
+//files smaller than this are parsed on a single thread
+const size_t PARALLEL_LOAD_BYTES = 64 << 20;
+
+//parses the lines in [begin, end) into x and y starting at index 0
+//each line holds two numbers separated by whitespace, blank lines and lines starting with # are skipped
+//returns how many points were read, or sets badLine to the 1-based line number of the first
+//malformed line, counting from firstLine
+size_t parseLines(const char* begin, const char* end, size_t firstLine, double* x, double* y, size_t& badLine)
+{
+  size_t count = 0;
+  size_t line = firstLine;
+  const char* p = begin;
+  badLine = 0;
+  while(p < end)
+  {
+    const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+    if(lineEnd == nullptr)
+      lineEnd = end;
+
+    while(p < lineEnd && (*p == ' ' || *p == '\t' || *p == '\r'))
+      p++;
+
+    if(p < lineEnd && *p != '#')
+    {
+      double values[2];
+      for(int k = 0; k < 2; k++)
+      {
+        while(p < lineEnd && (*p == ' ' || *p == '\t'))
+          p++;
+        //from_chars doesn't accept an explicit plus sign
+        if(p < lineEnd && *p == '+')
+          p++;
+        std::from_chars_result parsed = std::from_chars(p, lineEnd, values[k]);
+        if(parsed.ec != std::errc())
+        {
+          badLine = line;
+          return count;
+        }
+        p = parsed.ptr;
+      }
+
+      //only whitespace may follow the two numbers
+      while(p < lineEnd && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+      if(p != lineEnd)
+      {
+        badLine = line;
+        return count;
+      }
+
+      x[count] = values[0];
+      y[count] = values[1];
+      count++;
+    }
+
+    p = lineEnd + 1;
+    line++;
+  }
+  return count;
+}
+
+//reads the data points in fileName by memory mapping it and parsing with std::from_chars
+//large files are cut into chunks at line breaks and the chunks are parsed in parallel
+//throws std::runtime_error naming the line number if a line isn't two numbers
+PointData loadPoints(const std::string& fileName)
+{
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if(fd < 0)
+    throw std::runtime_error("could not open " + fileName);
+
+  struct stat info;
+  fstat(fd, &info);
+  size_t size = info.st_size;
+  PointData data;
+  if(size == 0)
+  {
+    close(fd);
+    return data;
+  }
+
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(mapping == MAP_FAILED)
+    throw std::runtime_error("could not map " + fileName);
+  madvise(mapping, size, MADV_SEQUENTIAL);
+  const char* text = static_cast<const char*>(mapping);
+
+  //cut the file into one chunk per thread, moving each cut to just after a line break
+  int threads = 1;
+  if(size >= PARALLEL_LOAD_BYTES)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<const char*> cuts(threads+1);
+  cuts[0] = text;
+  cuts[threads] = text + size;
+  for(int t = 1; t < threads; t++)
+  {
+    const char* cut = std::max(text + size*t/threads, cuts[t-1]);
+    const char* lineBreak = static_cast<const char*>(memchr(cut, '\n', text + size - cut));
+    cuts[t] = lineBreak ? lineBreak + 1 : text + size;
+  }
+
+  //count the lines in each chunk so every chunk knows its first line number
+  //and where its points go in the preallocated arrays
+  std::vector<size_t> firstLine(threads+1, 0);
+  for(int t = 0; t < threads; t++)
+    firstLine[t+1] = firstLine[t] + std::count(cuts[t], cuts[t+1], '\n');
+  if(text[size-1] != '\n')
+    firstLine[threads]++;
+
+  data.x.resize(firstLine[threads]);
+  data.y.resize(firstLine[threads]);
+
+  std::vector<size_t> counts(threads), badLines(threads);
+  auto parseChunk = [&](int t)
+  {
+    counts[t] = parseLines(cuts[t], cuts[t+1], firstLine[t]+1, data.x.data() + firstLine[t], data.y.data() + firstLine[t], badLines[t]);
+  };
+
+  std::vector<std::thread> workers;
+  for(int t = 1; t < threads; t++)
+    workers.emplace_back(parseChunk, t);
+  parseChunk(0);
+  for(auto& worker : workers)
+    worker.join();
+  munmap(mapping, size);
+
+  //chunks are in file order so the first one with an error has the earliest bad line
+  for(int t = 0; t < threads; t++)
+  {
+    if(badLines[t] != 0)
+      throw std::runtime_error(fileName + ":" + std::to_string(badLines[t]) + ": expected two numbers");
+  }
+
+  //blank lines left gaps at the end of each chunk's slice, so close them up
+  size_t total = 0;
+  for(int t = 0; t < threads; t++)
+  {
+    std::copy(data.x.begin() + firstLine[t], data.x.begin() + firstLine[t] + counts[t], data.x.begin() + total);
+    std::copy(data.y.begin() + firstLine[t], data.y.begin() + firstLine[t] + counts[t], data.y.begin() + total);
+    total += counts[t];
+  }
+  data.x.resize(total);
+  data.y.resize(total);
+  return data;
+}
+
+//points with fewer entries than this are sorted on a single thread
+const size_t PARALLEL_SORT_POINTS = 1 << 20;
+
+//sorts points by x, cutting large inputs into one run per thread and merging the runs pairwise
+void sortPoints(std::vector<std::pair<double, double>>& points)
+{
+  auto byX = [](const std::pair<double, double>& a, const std::pair<double, double>& b)
+  {
+    return a.first < b.first;
+  };
+
+  size_t threads = 1;
+  if(points.size() >= PARALLEL_SORT_POINTS)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+
+  //runs[t] is where the tth run starts
+  std::vector<size_t> runs(threads+1);
+  for(size_t t = 0; t <= threads; t++)
+    runs[t] = points.size()*t/threads;
+
+  //the calling thread sorts the first run, so a single run starts no threads
+  std::vector<std::thread> workers;
+  for(size_t t = 1; t < threads; t++)
+    workers.emplace_back([&, t]() { std::sort(points.begin() + runs[t], points.begin() + runs[t+1], byX); });
+  std::sort(points.begin(), points.begin() + runs[1], byX);
+  for(auto& worker : workers)
+    worker.join();
+
+  //each round merges neighbouring runs in parallel and halves how many are left
+  for(size_t width = 1; width < threads; width *= 2)
+  {
+    workers.clear();
+    for(size_t t = 0; t + width < threads; t += 2*width)
+    {
+      auto begin = points.begin() + runs[t];
+      auto middle = points.begin() + runs[t+width];
+      auto end = points.begin() + runs[std::min(t+2*width, threads)];
+      workers.emplace_back([=]() { std::inplace_merge(begin, middle, end, byX); });
+    }
+    for(auto& worker : workers)
+      worker.join();
+  }
+}
+
+//gets data ready for spline and Lagrange construction, which need distinct x-values in increasing order
+//the points are sorted by x and points that share an x-value are replaced by one with their average y-value
+//throws std::runtime_error if any value is NaN or infinite
+void preparePoints(PointData& data)
+{
+  size_t n = data.x.size();
+  std::vector<std::pair<double, double>> points(n);
+  for(size_t i = 0; i < n; i++)
+  {
+    if(!std::isfinite(data.x[i]) || !std::isfinite(data.y[i]))
+      throw std::runtime_error("point " + std::to_string(i) + " is not finite");
+    points[i] = std::make_pair(data.x[i], data.y[i]);
+  }
+
+  //data usually arrives in order, in which case there is nothing to sort
+  if(!std::is_sorted(data.x.begin(), data.x.end()))
+    sortPoints(points);
+
+  size_t count = 0;
+  for(size_t i = 0; i < n;)
+  {
+    //average every point from i up to the next x-value
+    size_t j = i;
+    double sum = 0;
+    while(j < n && points[j].first == points[i].first)
+      sum += points[j++].second;
+
+    data.x[count] = points[i].first;
+    data.y[count] = sum/(j - i);
+    count++;
+    i = j;
+  }
+  data.x.resize(count);
+  data.y.resize(count);
+}
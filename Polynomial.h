@@ -1,66 +1,183 @@
-//class to represent a polynomial
+//class to represent a polynomial whose coefficients have type T
 //Written by Adam Steinberg
 #pragma once
+#include "Metrics.h"
+#include "RootFinding.h"
 #include <vector>
+#include <memory>
+#include <memory_resource>
+#include <utility>
 #include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
 #include <ostream>
+#include <functional>
 
-class Polynomial
+//the outcome of an iterative root finder
+//converged is false when the iteration hit its limit, stopped on a zero derivative
+//or diverged to infinity or NaN, in which case root is the last finite iterate
+template <typename T>
+struct RootResult
+{
+  T root;
+  int iterations;
+  bool converged;
+};
+
+//Allocator supplies the memory for the coefficients and every polynomial made from this one,
+//such as its derivative, its powers and the results of the operators, uses the same one
+template <typename T, typename Allocator = std::allocator<T>>
+class BasicPolynomial
 {
   private:
-    std::vector<long double> coefficients;
+    std::vector<T, Allocator> coefficients;
+
+    //removes zero coefficients from the top so the vector isn't bigger than it needs to be
+    //the constant term is always kept so the zero polynomial is 0x^0
+    void trim()
+    {
+      while(coefficients.size() > 1 && coefficients.back() == 0)
+      {
+        coefficients.pop_back();
+      }
+    }
 
-    //returns the result of distributing ax^n to this polynomial
-    Polynomial distribute(long double a, int n) const
+    //multiplies a (na coefficients) by b (nb coefficients) the schoolbook way
+    //and stores the na+nb-1 coefficients of the product in r
+    static void convolve(const T* a, int na, const T* b, int nb, T* r)
     {
-      std::vector<long double> resultCoefficients;
-      for(int i = 0; i < n; i++)
+      std::fill(r, r + na + nb - 1, T(0));
+      for(int i = 0; i < na; i++)
       {
-        resultCoefficients.push_back(0.0);
+        for(int j = 0; j < nb; j++)
+        {
+          r[i+j] += a[i]*b[j];
+        }
       }
+    }
+
+    //multiplies a by b, which both have n coefficients, using Karatsuba's algorithm
+    //and stores the 2n-1 coefficients of the product in r
+    //scratch needs room for 5n coefficients
+    static void karatsuba(const T* a, const T* b, int n, T* r, T* scratch)
+    {
+      if(n <= std::max(1, karatsubaThreshold))
+      {
+        convolve(a, n, b, n, r);
+        return;
+      }
+
+      //split each operand into a low half of m coefficients and a high half of h
+      int m = n/2;
+      int h = n - m;
+
+      //low*low goes in r[0, 2m-1) and high*high goes in r[2m, 2n-1)
+      karatsuba(a, b, m, r, scratch);
+      r[2*m-1] = 0;
+      karatsuba(a+m, b+m, h, r+2*m, scratch);
 
-      for(int i = 0; i < coefficients.size(); i++)
+      //(low+high)*(low+high) - low*low - high*high is the middle term
+      T* sumA = scratch;
+      T* sumB = scratch + h;
+      T* middle = scratch + 2*h;
+      for(int i = 0; i < h; i++)
       {
-        resultCoefficients.push_back(a*coefficients[i]);
+        sumA[i] = a[m+i] + (i < m ? a[i] : 0);
+        sumB[i] = b[m+i] + (i < m ? b[i] : 0);
       }
-      return Polynomial(resultCoefficients);
+      karatsuba(sumA, sumB, h, middle, scratch + 4*h - 1);
+
+      for(int i = 0; i < 2*m-1; i++)
+        middle[i] -= r[i];
+      for(int i = 0; i < 2*h-1; i++)
+        middle[i] -= r[2*m+i];
+      for(int i = 0; i < 2*h-1; i++)
+        r[m+i] += middle[i];
+    }
+
+    //returns how far from 0 the rounding error of Horner's method can put the polynomial evaluated at x
+    T roundingBound(T x) const
+    {
+      T bound = 0;
+      for(int i = getDegree(); i >= 0; i--)
+        bound = bound*std::fabs(x) + std::fabs(coefficients[i]);
+      return 4*(getDegree()+1)*std::numeric_limits<T>::epsilon()*bound;
     }
 
   public:
+    typedef T value_type;
+
+    //limits for the iterative root finders
+    inline static const int MAX_ITERATIONS = 10000;
+    inline static const T TOLERANCE = 0.00000000001;
+
+    //operands with at most this many coefficients are multiplied the schoolbook way
+    //and larger ones are split with Karatsuba's algorithm
+    //values below 1 are treated as 1 since the recursion needs at least one coefficient to stop on
+    inline static int karatsubaThreshold = 32;
+
     //default constructor creates the polynomial 0x^0
-    Polynomial()
+    BasicPolynomial()
     {
       coefficients = {0.0};
     }
 
+    //creates the polynomial 0x^0 with its coefficients from allocator
+    explicit BasicPolynomial(const Allocator& allocator) : coefficients(1, T(0), allocator)
+    {
+    }
+
     //constructs a polynomial where args are the coefficients listed from lowest to highest degree
-    Polynomial(std::initializer_list<long double> args)
+    BasicPolynomial(std::initializer_list<T> args, const Allocator& allocator = Allocator()) : coefficients(args, allocator)
     {
-      coefficients = args;
+      METRICS_COUNT("polynomial.constructions", 1);
+      if(coefficients.empty())
+        coefficients = {0.0};
       //ensure that the coefficients vector isn't bigger than it needs to be
-      while(coefficients.back() == 0)
-      {
-        coefficients.pop_back();
-      }
+      trim();
     }
 
     //constructs a polynomial where args are the coefficients listed from lowest to highest degree
-    Polynomial(std::vector<long double> args)
+    //pass an rvalue to hand the vector over without copying it
+    BasicPolynomial(std::vector<T, Allocator> args) : coefficients(std::move(args))
     {
-      coefficients = args;
+      METRICS_COUNT("polynomial.constructions", 1);
+      if(coefficients.empty())
+        coefficients = {0.0};
       //ensure that the coefficients vector isn't bigger than it needs to be
-      while(coefficients.back() == 0)
-      {
-        coefficients.pop_back();
-      }
+      trim();
     }
 
-    std::vector<long double> getCoefficients() const
+    //copies a polynomial that uses another kind of allocator, such as one from an arena
+    //that is about to be released, into memory from allocator
+    template <typename OtherAllocator>
+    explicit BasicPolynomial(const BasicPolynomial<T, OtherAllocator>& other, const Allocator& allocator = Allocator())
+      : coefficients(other.getCoefficients().begin(), other.getCoefficients().end(), allocator)
+    {
+      METRICS_COUNT("polynomial.copies", 1);
+    }
+
+    //a copy uses the same allocator as the original, so copies of a polynomial in an arena stay in the arena
+    BasicPolynomial(const BasicPolynomial& other) : coefficients(other.coefficients, other.coefficients.get_allocator())
+    {
+      METRICS_COUNT("polynomial.copies", 1);
+    }
+    BasicPolynomial(BasicPolynomial&&) = default;
+    BasicPolynomial& operator=(const BasicPolynomial&) = default;
+    BasicPolynomial& operator=(BasicPolynomial&&) = default;
+
+    const std::vector<T, Allocator>& getCoefficients() const
     {
       return coefficients;
     }
 
-    long double operator[](int i) const
+    Allocator getAllocator() const
+    {
+      return coefficients.get_allocator();
+    }
+
+    T operator[](int i) const
     {
       return coefficients[i];
     }
@@ -70,137 +187,365 @@ class Polynomial
       return coefficients.size() - 1;
     }
 
-    //returns the polynomial evaluated at a specific x value
-    long double evaluate(long double x)
+    //returns the polynomial evaluated at a specific x value using Horner's method
+    T evaluate(T x) const
     {
-      long double result = 0;
-      for(int i = 0; i <= getDegree(); i++)
+      T result = coefficients.back();
+      for(int i = getDegree()-1; i >= 0; i--)
       {
-        result += coefficients[i]*pow(x,i);
+        result = result*x + coefficients[i];
       }
       return result;
     }
 
-    Polynomial derivative()
+    //evaluates the polynomial at the n values in xs and stores the results in ys
+    //points are handled in blocks so the innermost loop runs across independent
+    //points, which lets the compiler put each point in its own SIMD lane
+    void evaluate(const double* xs, double* ys, size_t n) const
+    {
+      const size_t BLOCK = 64;
+      T acc[BLOCK];
+      for(size_t start = 0; start < n; start += BLOCK)
+      {
+        size_t count = std::min(BLOCK, n - start);
+        for(size_t j = 0; j < count; j++)
+          acc[j] = coefficients.back();
+
+        for(int i = getDegree()-1; i >= 0; i--)
+        {
+          T c = coefficients[i];
+          for(size_t j = 0; j < count; j++)
+            acc[j] = acc[j]*xs[start+j] + c;
+        }
+
+        for(size_t j = 0; j < count; j++)
+          ys[start+j] = acc[j];
+      }
+    }
+
+    BasicPolynomial derivative() const
     {
       //derivative of a constant is 0
       if(getDegree() == 0)
-        return Polynomial();
+        return BasicPolynomial(getAllocator());
 
       //shift all the coefficients down by a degree
       //the x^0 term is removed because derivative of a constant is 0
-      std::vector<long double> resultCoefficients(coefficients.begin()+1, coefficients.end());
+      std::vector<T, Allocator> resultCoefficients(coefficients.begin()+1, coefficients.end(), getAllocator());
       for(int i = 0; i < resultCoefficients.size(); i++)
       {
         resultCoefficients[i] *= i+1;
       }
-      return Polynomial(resultCoefficients);
+      return BasicPolynomial(std::move(resultCoefficients));
+    }
+
+    //returns the polynomial and its first and second derivatives evaluated at x
+    //all three come from a single pass of Horner's method
+    Derivatives<T> evaluateDerivatives(T x) const
+    {
+      T value = coefficients.back();
+      T first = 0;
+      T second = 0;
+      for(int i = getDegree()-1; i >= 0; i--)
+      {
+        second = second*x + first;
+        first = first*x + value;
+        value = value*x + coefficients[i];
+      }
+      //the Horner recurrence builds p''(x)/2
+      return {value, first, 2*second};
     }
 
     //finds a root of the polynomial using Newton's Method with an initial approximation of p0
-    long double root(long double p0)
+    T root(T p0) const
     {
-      const int MAX_ITERATIONS = 10000;
-      const long double TOLERANCE = 0.00000000001;
+      return newton(p0).root;
+    }
 
-      Polynomial fPrime = derivative();
+    //finds a root of the polynomial using Newton's Method with an initial approximation of p0
+    //and reports how many iterations it took and whether it converged
+    RootResult<T> newton(T p0) const
+    {
+      METRICS_COUNT("polynomial.newton.calls", 1);
+      for (int i = 1; i <= MAX_ITERATIONS; i++)
+      {
+        METRICS_COUNT("polynomial.newton.iterations", 1);
+        Derivatives<T> f = evaluateDerivatives(p0);
+        if(f.first == 0)
+          return {p0, i, f.value == 0};
 
+        T p = p0 - f.value/f.first;
+        if(!std::isfinite(p))
+          return {p0, i, false};
+        if(std::fabs(p - p0) < TOLERANCE)
+        {
+          return {p, i, true};
+        }
+        p0 = p;
+      }
+      return {p0, MAX_ITERATIONS, false};
+    }
+
+    //finds a root of the polynomial using Halley's Method with an initial approximation of p0
+    //it uses the second derivative to converge cubically instead of quadratically
+    RootResult<T> halley(T p0) const
+    {
+      METRICS_COUNT("polynomial.halley.calls", 1);
       for (int i = 1; i <= MAX_ITERATIONS; i++)
       {
-        long double p = p0 - evaluate(p0)/fPrime.evaluate(p0);
-        if(fabs(p - p0) < TOLERANCE)
+        METRICS_COUNT("polynomial.halley.iterations", 1);
+        Derivatives<T> f = evaluateDerivatives(p0);
+        T denominator = 2*f.first*f.first - f.value*f.second;
+        if(denominator == 0)
+          return {p0, i, f.value == 0};
+
+        T p = p0 - 2*f.value*f.first/denominator;
+        if(!std::isfinite(p))
+          return {p0, i, false};
+        if(std::fabs(p - p0) < TOLERANCE)
         {
-          return p;
+          return {p, i, true};
         }
         p0 = p;
       }
-      return p0;
+      return {p0, MAX_ITERATIONS, false};
     }
 
-    Polynomial power(int n)
+    //returns every real root in [lo, hi] in increasing order without needing an initial guess
+    //the zero polynomial has no isolated roots so it returns none
+    //see findRealRoots for how the roots are bracketed
+    std::vector<T> realRoots(T lo, T hi) const
     {
-      if (n == 0)
-        return Polynomial({1});
-      if (n == 1)
-        return (*this);
-      if (n % 2 == 0)
+      METRICS_SCOPE("polynomial.realRoots");
+      int n = getDegree();
+      if(n == 0)
+        return std::vector<T>();
+      if(n == 1)
       {
-          Polynomial m = this->power(n / 2);
-          return m * m;
+        std::vector<T> roots;
+        T r = -coefficients[0]/coefficients[1];
+        if(r >= lo && r <= hi)
+          roots.push_back(r);
+        return roots;
       }
-      else
-        return (*this) * (this->power(n - 1));
+      return findRealRoots(*this, lo, hi, [this](T x) { return roundingBound(x); });
     }
 
-    friend Polynomial operator*(Polynomial a, Polynomial b);
+    //returns where the polynomial is largest on [lo, hi] and its value there
+    Extremum<T> globalMax(T lo, T hi) const
+    {
+      return findExtremum(*this, lo, hi, std::greater<T>());
+    }
+
+    //returns where the polynomial is smallest on [lo, hi] and its value there
+    Extremum<T> globalMin(T lo, T hi) const
+    {
+      return findExtremum(*this, lo, hi, std::less<T>());
+    }
+
+    BasicPolynomial power(int n) const
+    {
+      //square and multiply, reusing the same two buffers the whole way
+      BasicPolynomial result({1}, getAllocator());
+      BasicPolynomial base = *this;
+      while (n > 0)
+      {
+        if (n % 2 == 1)
+          result *= base;
+        n /= 2;
+        if (n > 0)
+          base *= base;
+      }
+      return result;
+    }
+
+    BasicPolynomial& operator+=(const BasicPolynomial& b)
+    {
+      if(b.coefficients.size() > coefficients.size())
+        coefficients.resize(b.coefficients.size(), 0.0);
+
+      for(int i = 0; i <= b.getDegree(); i++)
+      {
+        coefficients[i] += b[i];
+      }
+      trim();
+      return *this;
+    }
+
+    BasicPolynomial& operator-=(const BasicPolynomial& b)
+    {
+      if(b.coefficients.size() > coefficients.size())
+        coefficients.resize(b.coefficients.size(), 0.0);
+
+      for(int i = 0; i <= b.getDegree(); i++)
+      {
+        coefficients[i] -= b[i];
+      }
+      trim();
+      return *this;
+    }
+
+    BasicPolynomial& operator+=(T scalar)
+    {
+      coefficients[0] += scalar;
+      return *this;
+    }
+
+    BasicPolynomial& operator*=(T scalar)
+    {
+      for(T& c : coefficients)
+        c *= scalar;
+      trim();
+      return *this;
+    }
+
+    BasicPolynomial& operator/=(T scalar)
+    {
+      for(T& c : coefficients)
+        c /= scalar;
+      trim();
+      return *this;
+    }
+
+    BasicPolynomial& operator*=(const BasicPolynomial& b)
+    {
+      METRICS_COUNT("polynomial.multiplications", 1);
+      int na = coefficients.size();
+      int nb = b.coefficients.size();
+
+      if(std::min(na, nb) > std::max(1, karatsubaThreshold))
+      {
+        METRICS_COUNT("polynomial.karatsuba", 1);
+        //Karatsuba works on equal length operands, so the longer one is cut into
+        //pieces the length of the shorter one and the partial products are summed
+        const BasicPolynomial& shorter = na < nb ? *this : b;
+        const BasicPolynomial& longer = na < nb ? b : *this;
+        int n = shorter.coefficients.size();
+        int total = longer.coefficients.size();
+
+        std::vector<T, Allocator> result(na+nb-1, T(0), getAllocator());
+        std::vector<T, Allocator> piece(n, T(0), getAllocator());
+        std::vector<T, Allocator> product(2*n-1, T(0), getAllocator());
+        std::vector<T, Allocator> scratch(5*n, T(0), getAllocator());
+        for(int start = 0; start < total; start += n)
+        {
+          int count = std::min(n, total - start);
+          std::copy(longer.coefficients.begin() + start, longer.coefficients.begin() + start + count, piece.begin());
+          std::fill(piece.begin() + count, piece.end(), T(0));
+          karatsuba(piece.data(), shorter.coefficients.data(), n, product.data(), scratch.data());
+          for(int i = 0; i < count + n - 1; i++)
+            result[start+i] += product[i];
+        }
+        coefficients.swap(result);
+      }
+      else if(&b == this)
+      {
+        //squaring in place would overwrite b while it is still being read
+        std::vector<T, Allocator> result(na+nb-1, T(0), getAllocator());
+        convolve(coefficients.data(), na, b.coefficients.data(), nb, result.data());
+        coefficients.swap(result);
+      }
+      else
+      {
+        //work down from the highest degree so each coefficient of this polynomial
+        //is read for the last time before its slot is overwritten
+        coefficients.resize(na+nb-1, 0.0);
+        for(int k = na+nb-2; k >= 0; k--)
+        {
+          T sum = 0;
+          for(int i = std::max(0, k-nb+1); i <= std::min(k, na-1); i++)
+          {
+            sum += coefficients[i]*b.coefficients[k-i];
+          }
+          coefficients[k] = sum;
+        }
+      }
+      trim();
+      return *this;
+    }
 };
 
-Polynomial operator+(Polynomial a, Polynomial b)
+//double is the fast default that the compiler can vectorize
+//LongPolynomial keeps the extra precision of long double when it is needed
+typedef BasicPolynomial<double> Polynomial;
+typedef BasicPolynomial<long double> LongPolynomial;
+
+//polynomials whose coefficients come from a std::pmr::memory_resource
+//building a long expression on a std::pmr::monotonic_buffer_resource turns every temporary
+//into a pointer bump, and the whole build is freed at once when the resource is released
+//copy the result into a Polynomial before that if it needs to outlive the arena
+typedef BasicPolynomial<double, std::pmr::polymorphic_allocator<double>> ArenaPolynomial;
+typedef BasicPolynomial<long double, std::pmr::polymorphic_allocator<long double>> LongArenaPolynomial;
+
+//the operators take an operand by value only when the result is built in it, so an rvalue
+//operand is reused instead of copied and an lvalue operand is copied once
+template <typename T, typename Allocator>
+BasicPolynomial<T, Allocator> operator+(BasicPolynomial<T, Allocator> a, const BasicPolynomial<T, Allocator>& b)
 {
-  int resultDegree = std::max(a.getDegree(), b.getDegree());
-  std::vector<long double> resultCoefficients(resultDegree+1, 0);
+  a += b;
+  return a;
+}
 
-  for(int i = 0; i <= a.getDegree(); i++)
-  {
-    resultCoefficients[i] += a[i];
-  }
+template <typename T, typename Allocator>
+BasicPolynomial<T, Allocator> operator+(const BasicPolynomial<T, Allocator>& a, BasicPolynomial<T, Allocator>&& b)
+{
+  b += a;
+  return std::move(b);
+}
 
-  for(int i = 0; i <= b.getDegree(); i++)
-  {
-    resultCoefficients[i] += b[i];
-  }
-  return Polynomial(resultCoefficients);
+template <typename T, typename Allocator>
+BasicPolynomial<T, Allocator> operator*(typename BasicPolynomial<T, Allocator>::value_type scalar, BasicPolynomial<T, Allocator> p)
+{
+  p *= scalar;
+  return p;
 }
 
-Polynomial operator*(long double scalar, Polynomial p)
+template <typename T, typename Allocator>
+BasicPolynomial<T, Allocator> operator+(typename BasicPolynomial<T, Allocator>::value_type scalar, BasicPolynomial<T, Allocator> p)
 {
-  std::vector<long double> resultCoefficients;
-  int n = p.getDegree();
-  for (int i = 0; i <= n; i++)
-  {
-    resultCoefficients.push_back(scalar * p[i]);
-  }
-  return Polynomial(resultCoefficients);
+  p += scalar;
+  return p;
 }
 
-Polynomial operator+(long double scalar, Polynomial p)
+template <typename T, typename Allocator>
+BasicPolynomial<T, Allocator> operator/(BasicPolynomial<T, Allocator> p, typename BasicPolynomial<T, Allocator>::value_type scalar)
 {
-  std::vector<long double> resultCoefficients = p.getCoefficients();
-  resultCoefficients[0] += scalar;
-  return Polynomial(resultCoefficients);
+  p /= scalar;
+  return p;
 }
 
-Polynomial operator/(Polynomial p, long double scalar)
+template <typename T, typename Allocator>
+BasicPolynomial<T, Allocator> operator-(BasicPolynomial<T, Allocator> a, const BasicPolynomial<T, Allocator>& b)
 {
-  std::vector<long double> resultCoefficients;
-  int n = p.getDegree();
-  for (int i = 0; i <= n; i++)
-  {
-    resultCoefficients.push_back(p[i]/scalar);
-  }
-  return Polynomial(resultCoefficients);
+  a -= b;
+  return a;
 }
 
-Polynomial operator-(Polynomial a, Polynomial b)
+template <typename T, typename Allocator>
+BasicPolynomial<T, Allocator> operator-(const BasicPolynomial<T, Allocator>& a, BasicPolynomial<T, Allocator>&& b)
 {
-  return a+(-1*b);
+  //a - b is -b + a, which is built in b
+  b *= -1;
+  b += a;
+  return std::move(b);
 }
 
-Polynomial operator*(Polynomial a, Polynomial b)
+template <typename T, typename Allocator>
+BasicPolynomial<T, Allocator> operator*(BasicPolynomial<T, Allocator> a, const BasicPolynomial<T, Allocator>& b)
 {
-  Polynomial result;
-  for(int i = 0; i <= a.getDegree(); i++)
-  {
-      if(a[i]!=0)
-      {
-        result = result + b.distribute(a[i], i);
-      }
-  }
+  a *= b;
+  return a;
+}
 
-  return result;
+template <typename T, typename Allocator>
+BasicPolynomial<T, Allocator> operator*(const BasicPolynomial<T, Allocator>& a, BasicPolynomial<T, Allocator>&& b)
+{
+  b *= a;
+  return std::move(b);
 }
 
-std::ostream& operator<<(std::ostream& os, const Polynomial& p)
+template <typename T, typename Allocator>
+std::ostream& operator<<(std::ostream& os, const BasicPolynomial<T, Allocator>& p)
 {
   int n = p.getDegree();
   for (int i =0; i <= n; i++)
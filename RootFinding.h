@@ -0,0 +1,125 @@
+//root and extremum search shared by the polynomial classes
+//the functions work on anything with evaluate(x), evaluateDerivatives(x) and derivative(),
+//so each class keeps its own representation and nothing is expanded into powers of x
+#pragma once
+#include "Metrics.h"
+#include <vector>
+#include <cstddef>
+#include <cmath>
+
+//a point x where a function reaches an extreme value
+template <typename T>
+struct Extremum
+{
+  T x;
+  T value;
+};
+
+//a polynomial and its first two derivatives evaluated at the same point
+template <typename T>
+struct Derivatives
+{
+  T value;
+  T first;
+  T second;
+};
+
+//finds the only root in [a, b] given that p is monotonic there and changes sign
+//fa is p evaluated at a
+//Newton's method is used while it stays inside the bracket and bisection otherwise
+template <typename P, typename T>
+T bracketedRoot(const P& p, T a, T b, T fa)
+{
+  const int MAX_STEPS = 200;
+  T x = a + (b - a)/2;
+  for(int i = 0; i < MAX_STEPS; i++)
+  {
+    METRICS_COUNT("polynomial.bracketedRoot.iterations", 1);
+    Derivatives<T> f = p.evaluateDerivatives(x);
+    T fx = f.value;
+    if(fx == 0)
+      return x;
+
+    //shrink the bracket to the half that still has the sign change
+    if((fx < 0) == (fa < 0))
+    {
+      a = x;
+      fa = fx;
+    }
+    else
+    {
+      b = x;
+    }
+
+    T next = x - fx/f.first;
+    if(!(next > a && next < b))
+      next = a + (b - a)/2;
+    if(next == x || next == a || next == b)
+      return next;
+    x = next;
+  }
+  return x;
+}
+
+//returns every real root of p in [lo, hi] in increasing order without needing an initial guess
+//the critical points, which are p.derivative().realRoots(lo, hi), cut [lo, hi] into pieces where
+//p is monotonic, so each piece holds at most one root and that root is bracketed by a sign change
+//roots that only touch zero are found at the critical points
+//roundingBound(x) is how far from 0 rounding error alone can put p evaluated at x,
+//so a value within it is treated as a root
+template <typename P, typename T, typename RoundingBound>
+std::vector<T> findRealRoots(const P& p, T lo, T hi, const RoundingBound& roundingBound)
+{
+  std::vector<T> roots;
+  std::vector<T> ends = p.derivative().realRoots(lo, hi);
+  ends.insert(ends.begin(), lo);
+  ends.push_back(hi);
+
+  auto addRoot = [&roots](T r)
+  {
+    if(roots.empty() || r != roots.back())
+      roots.push_back(r);
+  };
+  auto isZero = [&roundingBound](T x, T value)
+  {
+    return std::fabs(value) <= roundingBound(x);
+  };
+
+  T fa = p.evaluate(ends[0]);
+  if(isZero(ends[0], fa))
+    addRoot(ends[0]);
+  for(size_t i = 1; i < ends.size(); i++)
+  {
+    T a = ends[i-1];
+    T b = ends[i];
+    T fb = p.evaluate(b);
+    if(isZero(b, fb))
+    {
+      addRoot(b);
+    }
+    else if(!isZero(a, fa) && (fa < 0) != (fb < 0))
+    {
+      addRoot(bracketedRoot(p, a, b, fa));
+    }
+    fa = fb;
+  }
+  return roots;
+}
+
+//returns where p is most extreme on [lo, hi] and its value there
+//better(a, b) is true when the value a beats the value b, such as std::greater for the maximum
+//the extremum is at lo, hi or one of the critical points
+template <typename P, typename T, typename Better>
+Extremum<T> findExtremum(const P& p, T lo, T hi, const Better& better)
+{
+  Extremum<T> best = {lo, p.evaluate(lo)};
+  std::vector<T> points = p.derivative().realRoots(lo, hi);
+  points.push_back(hi);
+  for(T x : points)
+  {
+    T value = p.evaluate(x);
+    if(better(value, best.value))
+      best = {x, value};
+  }
+  return best;
+}
@@ -0,0 +1,844 @@
+//class to represent a cubic spline and functions to construct one
+#pragma once
+#include "Polynomial.h"
+#include "FixedPolynomial.h"
+#include "Metrics.h"
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <thread>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+//systems with fewer rows than this are solved on a single thread
+const size_t PARALLEL_SOLVE_ROWS = 1 << 20;
+
+//solves the same tridiagonal system as solveTridiagonal by cutting it into one block of rows per thread
+//each block is solved on its own as if its neighbours were 0, which leaves only the first and last
+//unknown of each block coupled to the next block, then those 2*threads unknowns are solved
+//together and each block corrects its solution in parallel
+//for the diagonally dominant spline systems every step is well conditioned, so the answer
+//matches solveTridiagonal to within 1e-13 times the largest |x_i|
+void solveTridiagonalParallel(const std::vector<double>& sub, const std::vector<double>& diag, std::vector<double>& super, std::vector<double>& d, int threads)
+{
+  METRICS_SCOPE("spline.solveParallel");
+  size_t n = diag.size();
+  int blocks = std::max<size_t>(1, std::min<size_t>(threads, n));
+  std::vector<size_t> start(blocks+1);
+  for(int p = 0; p <= blocks; p++)
+    start[p] = n*p/blocks;
+
+  //for the block of rows [s, e), with A_p the block's own part of the matrix:
+  //y = A_p^-1 d, v = sub[s]*(first column of A_p^-1) and w = super[e-1]*(last column of A_p^-1)
+  //so x = y - x[s-1]*v - x[e]*w, and only the first and last entries of each are kept
+  struct Ends
+  {
+    double lower, upper;
+    double yFirst, yLast, vFirst, vLast, wFirst, wLast;
+    //the first entry of the first column and the last entry of the last column of A_p^-1
+    double inverseFirstFirst, inverseLastLast;
+  };
+  std::vector<Ends> ends(blocks);
+  //ratio[i] = sub[i]/(pivot of row i when the block is eliminated from the bottom up),
+  //which gives the first column of A_p^-1 one entry at a time
+  std::vector<double> ratio(n);
+
+  auto solveBlock = [&](int p)
+  {
+    size_t s = start[p], e = start[p+1];
+    Ends& end = ends[p];
+    end.lower = p > 0 ? sub[s] : 0;
+    end.upper = p < blocks-1 ? super[e-1] : 0;
+
+    //eliminate from the bottom up to find the first column of A_p^-1 at row s
+    double pivot = diag[e-1];
+    for(size_t i = e-1; i > s; i--)
+    {
+      ratio[i] = sub[i]/pivot;
+      pivot = diag[i-1] - super[i-1]*ratio[i];
+    }
+    end.inverseFirstFirst = 1/pivot;
+
+    //Thomas algorithm on the block, also carrying the first column of A_p^-1 down to row e-1
+    pivot = diag[s];
+    double column = 1/pivot;
+    d[s] /= pivot;
+    for(size_t i = s+1; i < e; i++)
+    {
+      super[i-1] /= pivot;
+      pivot = diag[i] - sub[i]*super[i-1];
+      d[i] = (d[i] - sub[i]*d[i-1])/pivot;
+      column = -sub[i]*column/pivot;
+    }
+    end.inverseLastLast = 1/pivot;
+    double inverseLastFirst = column;
+
+    //back substitution, also carrying the last column of A_p^-1 up to row s
+    column = end.inverseLastLast;
+    //counts i down from e-2 to s
+    for(size_t i = e-1; i-- > s; )
+    {
+      d[i] -= super[i]*d[i+1];
+      column *= -super[i];
+    }
+
+    end.yFirst = d[s];
+    end.yLast = d[e-1];
+    end.vFirst = end.lower*end.inverseFirstFirst;
+    end.vLast = end.lower*inverseLastFirst;
+    end.wFirst = end.upper*column;
+    end.wLast = end.upper*end.inverseLastLast;
+  };
+
+  std::vector<std::thread> workers;
+  for(int p = 1; p < blocks; p++)
+    workers.emplace_back(solveBlock, p);
+  solveBlock(0);
+  for(auto& worker : workers)
+    worker.join();
+
+  //the unknowns x[start[p]] and x[start[p+1]-1] are z[2p] and z[2p+1]
+  //row 2p is z[2p] + vFirst*z[2p-1] + wFirst*z[2p+2] = yFirst and row 2p+1 is the same with the last entries,
+  //so the reduced system only has entries within two places of the diagonal
+  //it is diagonally dominant like the full system so Gaussian elimination needs no pivoting
+  int m = 2*blocks;
+  std::vector<double> band(m*5, 0.0), z(m);
+  auto at = [&](int row, int col) -> double& { return band[row*5 + col-row+2]; };
+  for(int p = 0; p < blocks; p++)
+  {
+    at(2*p, 2*p) = 1;
+    at(2*p+1, 2*p+1) = 1;
+    if(p > 0)
+    {
+      at(2*p, 2*p-1) = ends[p].vFirst;
+      at(2*p+1, 2*p-1) = ends[p].vLast;
+    }
+    if(p < blocks-1)
+    {
+      at(2*p, 2*p+2) = ends[p].wFirst;
+      at(2*p+1, 2*p+2) = ends[p].wLast;
+    }
+    z[2*p] = ends[p].yFirst;
+    z[2*p+1] = ends[p].yLast;
+  }
+  for(int k = 0; k < m; k++)
+  {
+    for(int i = k+1; i <= std::min(k+2, m-1); i++)
+    {
+      double factor = at(i, k)/at(k, k);
+      for(int j = k; j <= std::min(k+2, m-1); j++)
+        at(i, j) -= factor*at(k, j);
+      z[i] -= factor*z[k];
+    }
+  }
+  for(int k = m-1; k >= 0; k--)
+  {
+    for(int j = k+1; j <= std::min(k+2, m-1); j++)
+      z[k] -= at(k, j)*z[j];
+    z[k] /= at(k, k);
+  }
+
+  //x = y - x[s-1]*v - x[e]*w, rebuilding the columns of A_p^-1 from the saved eliminations
+  auto correctBlock = [&](int p)
+  {
+    size_t s = start[p], e = start[p+1];
+    if(p > 0)
+    {
+      double scale = z[2*p-1]*ends[p].lower;
+      double column = ends[p].inverseFirstFirst;
+      for(size_t i = s; i < e; i++)
+      {
+        if(i > s)
+          column *= -ratio[i];
+        d[i] -= scale*column;
+      }
+    }
+    if(p < blocks-1)
+    {
+      double scale = z[2*p+2]*ends[p].upper;
+      double column = ends[p].inverseLastLast;
+      //counts i down from e-1 to s
+      for(size_t i = e; i-- > s; )
+      {
+        if(i < e-1)
+          column *= -super[i];
+        d[i] -= scale*column;
+      }
+    }
+  };
+
+  workers.clear();
+  for(int p = 1; p < blocks; p++)
+    workers.emplace_back(correctBlock, p);
+  correctBlock(0);
+  for(auto& worker : workers)
+    worker.join();
+}
+
+//solves the tridiagonal system A*x = d using the Thomas algorithm in O(n) time
+//sub[i] is A(i,i-1), diag[i] is A(i,i), and super[i] is A(i,i+1)
+//sub[0] and super[n-1] are never read
+//the solution is written into d and super is overwritten as scratch space
+//the spline systems are strictly diagonally dominant so no pivoting is needed
+//systems with at least PARALLEL_SOLVE_ROWS rows are solved with solveTridiagonalParallel
+void solveTridiagonal(const std::vector<double>& sub, const std::vector<double>& diag, std::vector<double>& super, std::vector<double>& d)
+{
+  METRICS_SCOPE("spline.solve");
+  size_t n = diag.size();
+  if(n >= PARALLEL_SOLVE_ROWS && std::thread::hardware_concurrency() > 1)
+  {
+    solveTridiagonalParallel(sub, diag, super, d, std::thread::hardware_concurrency());
+    return;
+  }
+
+  //forward sweep: eliminate the subdiagonal
+  super[0] = super[0]/diag[0];
+  d[0] = d[0]/diag[0];
+  for(size_t i = 1; i < n; i++)
+  {
+    double m = diag[i] - sub[i]*super[i-1];
+    if(i < n-1)
+      super[i] = super[i]/m;
+    d[i] = (d[i] - sub[i]*d[i-1])/m;
+  }
+
+  //back substitution, counting i down from n-2 to 0
+  for(size_t i = n-1; i-- > 0; )
+    d[i] -= super[i]*d[i+1];
+}
+
+//the extreme values of a spline
+struct SplineExtrema
+{
+  Extremum<double> max;
+  Extremum<double> min;
+  //every local maximum and minimum inside the knots in increasing order of x
+  //these are only filled in when they are asked for
+  std::vector<Extremum<double>> localMaxima;
+  std::vector<Extremum<double>> localMinima;
+};
+
+//one cubic of a spline in the shifted form it was fit in: a + b(x-knot) + c(x-knot)^2 + d(x-knot)^3
+//evaluating in this form is as accurate as the fit, where expanding it into powers of x
+//cancels badly when the knot is far from 0
+struct SplineSegment
+{
+  double knot;
+  //the cubic in powers of (x - knot)
+  FixedPolynomial<3> cubic;
+
+  double evaluate(double x) const
+  {
+    return cubic.evaluate(x - knot);
+  }
+
+  //expands the cubic into powers of x by multiplying out the nested form one factor of (x - knot) at a time
+  //the work is done inline so the only allocation is the result's
+  Polynomial toPolynomial() const
+  {
+    FixedPolynomial<3> result;
+    for(int k = 3; k >= 0; k--)
+    {
+      //result = result*(x - knot) + cubic[k]
+      for(int j = 3; j > 0; j--)
+        result[j] = result[j-1] - knot*result[j];
+      result[0] = cubic[k] - knot*result[0];
+    }
+    return result.toPolynomial();
+  }
+};
+
+//writes the cubic in its shifted form, such as 1 + 2(x - 3) + 4(x - 3)^3
+std::ostream& operator<<(std::ostream& os, const SplineSegment& segment)
+{
+  std::stringstream shift;
+  shift.copyfmt(os);
+  if(segment.knot == 0)
+    shift << "x";
+  else if(segment.knot > 0)
+    shift << "(x - " << segment.knot << ")";
+  else
+    shift << "(x + " << -segment.knot << ")";
+
+  bool first = true;
+  for(int k = 0; k <= 3; k++)
+  {
+    if(segment.cubic[k] == 0)
+      continue;
+    if(!first)
+      os << " + ";
+    first = false;
+
+    os << segment.cubic[k];
+    if(k != 0)
+      os << shift.str();
+    if(k > 1)
+      os << "^" << k;
+  }
+  //a zero cubic still prints something
+  if(first)
+    os << 0;
+  return os;
+}
+
+//splines with fewer cubics than this are searched for extrema on a single thread
+const size_t PARALLEL_EXTREMA_SEGMENTS = 1 << 16;
+
+//class to read a cubic spline stored in memory it doesn't own
+//the ith cubic is S_i(x) = a_i + b_i(x-x_i) + c_i(x-x_i)^2 + d_i(x-x_i)^3 and covers [x_i, x_{i+1}]
+//a spline of n cubics is stored as one block of 5n+1 doubles laid out column by column:
+//x_0 ... x_n, then a_0 ... a_{n-1}, then the b, c and d constants the same way
+class CubicSplineView
+{
+  protected:
+    const double* knots;
+    const double* a;
+    const double* b;
+    const double* c;
+    const double* d;
+    size_t count;
+
+    //points the columns into block, which holds a spline of n cubics
+    void bind(const double* block, size_t n)
+    {
+      count = n;
+      knots = block;
+      a = knots + n+1;
+      b = a + n;
+      c = b + n;
+      d = c + n;
+    }
+
+    //finds the extrema of the cubics in [first, last) and merges them into result
+    //the derivative of the ith cubic is b_i + 2c_i*t + 3d_i*t^2 with t = x - x_i,
+    //so its critical points come straight from the quadratic formula
+    void segmentExtrema(size_t first, size_t last, bool findLocal, SplineExtrema& result) const
+    {
+      for(size_t i = first; i < last; i++)
+      {
+        double h = knots[i+1] - knots[i];
+        double A = 3*d[i];
+        double B = 2*c[i];
+        double C = b[i];
+
+        //find the roots t of A*t^2 + B*t + C that are inside this cubic
+        double roots[2];
+        int found = 0;
+        if(A == 0)
+        {
+          if(B != 0)
+            roots[found++] = -C/B;
+        }
+        else
+        {
+          double discriminant = B*B - 4*A*C;
+          //a double root doesn't change the sign of the derivative so it is not an extremum
+          if(discriminant > 0)
+          {
+            //this form avoids subtracting nearly equal numbers
+            double q = -(B + std::copysign(std::sqrt(discriminant), B))/2;
+            roots[found++] = q/A;
+            if(q != 0)
+              roots[found++] = C/q;
+          }
+        }
+        if(found == 2 && roots[0] > roots[1])
+          std::swap(roots[0], roots[1]);
+
+        //the right end of each cubic is the left end of the next one, and the last
+        //knot is the end of the spline, so only the left end is included here
+        for(int k = 0; k < found; k++)
+        {
+          double t = roots[k];
+          if(t < 0 || t >= h || (i == 0 && t == 0))
+            continue;
+
+          Extremum<double> point = {knots[i] + t, getSegment(i).cubic.evaluate(t)};
+          if(point.value > result.max.value)
+            result.max = point;
+          if(point.value < result.min.value)
+            result.min = point;
+
+          if(findLocal)
+          {
+            //the second derivative tells a maximum from a minimum
+            if(B + 2*A*t < 0)
+              result.localMaxima.push_back(point);
+            else
+              result.localMinima.push_back(point);
+          }
+        }
+      }
+    }
+
+  public:
+    //reads the spline of n cubics stored in block
+    CubicSplineView(const double* block, size_t n)
+    {
+      bind(block, n);
+    }
+
+    //returns how many cubics make up the spline
+    size_t size() const
+    {
+      return count;
+    }
+
+    //returns x_i
+    double getKnot(int i) const
+    {
+      return knots[i];
+    }
+
+    //returns the start of the block the spline is stored in
+    const double* data() const
+    {
+      return knots;
+    }
+
+    //returns the index of the cubic that covers x using a binary search
+    //x-values outside the knots use the first or last cubic
+    int segment(double x) const
+    {
+      //only the interior knots separate one cubic from the next
+      return std::upper_bound(knots+1, knots+count, x) - (knots+1);
+    }
+
+    //returns the index of the cubic that covers x, checking the cubic at hint
+    //and the one after it before falling back to a binary search
+    //this makes a stream of increasing x-values cost O(1) per lookup
+    int segment(double x, int hint) const
+    {
+      int last = size()-1;
+      if(hint < 0 || hint > last)
+        return segment(x);
+
+      if(x >= knots[hint] || hint == 0)
+      {
+        if(hint == last || x < knots[hint+1])
+          return hint;
+        if(hint+1 == last || x < knots[hint+2])
+          return hint+1;
+      }
+      return segment(x);
+    }
+
+    //returns the spline evaluated at a specific x value
+    double evaluate(double x) const
+    {
+      return evaluateSegment(segment(x), x);
+    }
+
+    //returns the spline evaluated at a specific x value
+    //hint is the cubic used by the previous call and is updated to the one used by this call
+    double evaluate(double x, int& hint) const
+    {
+      hint = segment(x, hint);
+      return evaluateSegment(hint, x);
+    }
+
+    //evaluates the spline at the n values in xs and stores the results in ys
+    //sorted x-values are handled in one merge-style pass over the knots
+    void evaluate(const double* xs, double* ys, size_t n) const
+    {
+      if(std::is_sorted(xs, xs+n))
+      {
+        int i = n > 0 ? segment(xs[0]) : 0;
+        int last = size()-1;
+        for(size_t j = 0; j < n; j++)
+        {
+          while(i < last && xs[j] >= knots[i+1])
+            i++;
+          ys[j] = evaluateSegment(i, xs[j]);
+        }
+      }
+      else
+      {
+        int hint = 0;
+        for(size_t j = 0; j < n; j++)
+          ys[j] = evaluate(xs[j], hint);
+      }
+    }
+
+    //returns the ith cubic in the shifted form it was fit in
+    SplineSegment getSegment(int i) const
+    {
+      return {knots[i], {a[i], b[i], c[i], d[i]}};
+    }
+
+    //returns the ith cubic evaluated at a specific x value
+    double evaluateSegment(int i, double x) const
+    {
+      return getSegment(i).evaluate(x);
+    }
+
+    //returns the derivative of the spline at a specific x value
+    double derivative(double x) const
+    {
+      int i = segment(x);
+      return getSegment(i).cubic.derivative().evaluate(x - knots[i]);
+    }
+
+    //returns the largest and smallest values of the spline between its first and last knots
+    //and, if findLocal is true, every local maximum and minimum in between
+    //large splines are split into one run of cubics per thread and the results are merged
+    SplineExtrema extrema(bool findLocal = false) const
+    {
+      METRICS_SCOPE("spline.extrema");
+      Extremum<double> start = {knots[0], evaluate(knots[0])};
+      Extremum<double> end = {knots[count], evaluate(knots[count])};
+
+      int threads = 1;
+      if(size() >= PARALLEL_EXTREMA_SEGMENTS)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+      std::vector<SplineExtrema> partial(threads);
+      for(auto& part : partial)
+      {
+        part.max = start;
+        part.min = start;
+      }
+
+      std::vector<std::thread> workers;
+      for(int t = 1; t < threads; t++)
+        workers.emplace_back([&, t]() { segmentExtrema(size()*t/threads, size()*(t+1)/threads, findLocal, partial[t]); });
+      segmentExtrema(0, size()/threads, findLocal, partial[0]);
+      for(auto& worker : workers)
+        worker.join();
+
+      SplineExtrema result = partial[0];
+      for(int t = 1; t < threads; t++)
+      {
+        if(partial[t].max.value > result.max.value)
+          result.max = partial[t].max;
+        if(partial[t].min.value < result.min.value)
+          result.min = partial[t].min;
+        result.localMaxima.insert(result.localMaxima.end(), partial[t].localMaxima.begin(), partial[t].localMaxima.end());
+        result.localMinima.insert(result.localMinima.end(), partial[t].localMinima.begin(), partial[t].localMinima.end());
+      }
+
+      if(end.value > result.max.value)
+        result.max = end;
+      if(end.value < result.min.value)
+        result.min = end;
+      return result;
+    }
+
+    //returns the ith cubic expanded into a Polynomial in powers of x
+    //this is only for when the monomial form is needed, see SplineSegment::toPolynomial
+    Polynomial getPolynomial(int i) const
+    {
+      return getSegment(i).toPolynomial();
+    }
+};
+
+//class to represent a cubic spline that owns its block of constants
+class CubicSpline : public CubicSplineView
+{
+  private:
+    std::vector<double> storage;
+
+  public:
+    //makes room for a spline of n cubics whose constants are filled in through data()
+    explicit CubicSpline(size_t n) : CubicSplineView(nullptr, n), storage(5*n+1, 0.0)
+    {
+      bind(storage.data(), n);
+    }
+
+    CubicSpline(const CubicSpline& other) : CubicSplineView(other), storage(other.storage)
+    {
+      bind(storage.data(), count);
+    }
+
+    CubicSpline(CubicSpline&& other) noexcept : CubicSplineView(other), storage(std::move(other.storage))
+    {
+      bind(storage.data(), count);
+    }
+
+    CubicSpline& operator=(CubicSpline other)
+    {
+      storage.swap(other.storage);
+      bind(storage.data(), other.count);
+      return *this;
+    }
+
+    double* data()
+    {
+      return storage.data();
+    }
+
+    const double* data() const
+    {
+      return storage.data();
+    }
+};
+
+//writes the block of a spline of n cubics from the knots, the y-values at the knots and the c_i constants
+//each cubic we make is defined by four constants: a_i, b_i, c_i, d_i
+void writeSpline(const double* knots, const double* y, const double* c, size_t n, double* block)
+{
+  METRICS_SCOPE("spline.build");
+  double* a = block + n+1;
+  double* b = a + n;
+  double* cColumn = b + n;
+  double* d = cColumn + n;
+
+  std::copy(knots, knots+n+1, block);
+  std::copy(c, c+n, cColumn);
+  for(size_t i = 0; i < n; i++)
+  {
+    //calculate all the constants that define the ith cubic
+    double h = knots[i+1] - knots[i];
+    a[i] = y[i];
+    b[i] = (y[i+1] - y[i])/h - h*(c[i+1]+2*c[i])/3;
+    d[i] = (c[i+1]-c[i])/(3*h);
+  }
+}
+
+//builds a spline from the knots, the y-values at the knots and the c_i constants
+CubicSpline buildSpline(const std::vector<double>& knots, const double* y, const std::vector<double>& c)
+{
+  CubicSpline result(knots.size()-1);
+  writeSpline(knots.data(), y, c.data(), result.size(), result.data());
+  return result;
+}
+
+//fills in the three diagonals of the tridiagonal system A*c = alpha that the c_i constants solve
+//the system only depends on the knots and the kind of boundary conditions
+void splineSystem(const std::vector<double>& knots, bool clamped, std::vector<double>& sub, std::vector<double>& diag, std::vector<double>& super)
+{
+  METRICS_SCOPE("spline.system");
+  size_t n = knots.size()-1;
+  sub.assign(n+1, 0.0);
+  diag.assign(n+1, 0.0);
+  super.assign(n+1, 0.0);
+
+  for(size_t i = 1; i < n; i++)
+  {
+    sub[i] = knots[i] - knots[i-1];
+    diag[i] = 2*(knots[i+1] - knots[i-1]);
+    super[i] = knots[i+1] - knots[i];
+  }
+
+  if(clamped)
+  {
+    diag[0] = 2*(knots[1] - knots[0]);
+    super[0] = knots[1] - knots[0];
+    sub[n] = knots[n] - knots[n-1];
+    diag[n] = 2*(knots[n] - knots[n-1]);
+  }
+  else
+  {
+    //natural boundary conditions force c_0 = c_n = 0
+    diag[0] = 1.0;
+    diag[n] = 1.0;
+  }
+}
+
+//fills in alpha, the constants on the right side of the system of linear equations
+//alpha[i*stride] is the ith constant so several right sides can be interleaved
+//fpo and fpn are only used when the spline is clamped
+void splineRightSide(const std::vector<double>& knots, const double* y, bool clamped, double fpo, double fpn, double* alpha, size_t stride)
+{
+  size_t n = knots.size()-1;
+  for(size_t i = 1; i < n; i++)
+    alpha[i*stride] = 3/(knots[i+1]-knots[i])*(y[i+1] - y[i]) - 3/(knots[i]-knots[i-1])*(y[i] - y[i-1]);
+
+  if(clamped)
+  {
+    alpha[0] = 3*(y[1] - y[0])/(knots[1]-knots[0]) - 3*fpo;
+    alpha[n*stride] = 3*fpn - 3*(y[n] - y[n-1])/(knots[n]-knots[n-1]);
+  }
+  else
+  {
+    alpha[0] = 0;
+    alpha[n*stride] = 0;
+  }
+}
+
+//constructs a natural cubic spline through the points (x[i], y[i])
+CubicSpline cubicSpline(const std::vector<double>& x, const std::vector<double>& y)
+{
+  std::vector<double> sub, diag, super;
+  splineSystem(x, false, sub, diag, super);
+
+  std::vector<double> alpha(x.size());
+  splineRightSide(x, y.data(), false, 0, 0, alpha.data(), 1);
+
+  //solve A*c = alpha for c
+  //alpha now contains all our c_i constants
+  solveTridiagonal(sub, diag, super, alpha);
+
+  return buildSpline(x, y.data(), alpha);
+}
+
+//constructs a clamped cubic spline through the points (x[i], y[i]) and fpo and fpn
+//fpo is the derivative of f at x_0
+//fpn is the derivative of f at x_n
+CubicSpline clampedCubicSpline(const std::vector<double>& x, const std::vector<double>& y, double fpo, double fpn)
+{
+  std::vector<double> sub, diag, super;
+  splineSystem(x, true, sub, diag, super);
+
+  std::vector<double> alpha(x.size());
+  splineRightSide(x, y.data(), true, fpo, fpn, alpha.data(), 1);
+
+  //solve A*c = alpha for c
+  //alpha now contains all our c_i constants
+  solveTridiagonal(sub, diag, super, alpha);
+
+  return buildSpline(x, y.data(), alpha);
+}
+
+//splits points into a list of x-values and a list of y-values
+void splitPoints(const std::vector<std::pair<double, double>>& points, std::vector<double>& x, std::vector<double>& y)
+{
+  x.resize(points.size());
+  y.resize(points.size());
+  for(size_t i = 0; i < points.size(); i++)
+  {
+    x[i] = points[i].first;
+    y[i] = points[i].second;
+  }
+}
+
+//constructs a natural cubic spline from points
+CubicSpline cubicSpline(const std::vector<std::pair<double, double>>& points)
+{
+  std::vector<double> x, y;
+  splitPoints(points, x, y);
+  return cubicSpline(x, y);
+}
+
+//constructs a clamped cubic spline from points and fpo and fpn
+//fpo is the derivative of f at x_0
+//fpn is the derivative of f at x_n
+CubicSpline clampedCubicSpline(const std::vector<std::pair<double, double>>& points, double fpo, double fpn)
+{
+  std::vector<double> x, y;
+  splitPoints(points, x, y);
+  return clampedCubicSpline(x, y, fpo, fpn);
+}
+
+//class to fit many cubic splines that share the same knots
+//the tridiagonal system only depends on the knots, so it is factored once
+//and then solved for every set of y-values
+class SplineFactorization
+{
+  private:
+    std::vector<double> knots;
+    bool clamped;
+    //sub is the subdiagonal, upper is the superdiagonal divided by the pivots
+    //and inversePivot holds 1/pivot for each row of the Thomas algorithm
+    std::vector<double> sub, upper, inversePivot;
+
+    //how many y series are solved side by side
+    //the right sides are interleaved so the inner loops run across series
+    static constexpr int BLOCK = 8;
+
+    //fits the splines for the y series in ys[first, first+count)
+    void fitBlock(const std::vector<std::vector<double>>& ys, size_t first, size_t count, const std::vector<double>* fpo, const std::vector<double>* fpn, std::vector<CubicSpline>& result) const
+    {
+      METRICS_SCOPE("spline.factorizationBlock");
+      size_t n = knots.size()-1;
+
+      //alpha[i*BLOCK + j] is the ith constant of the jth series in the block
+      std::vector<double> alpha((n+1)*BLOCK, 0.0);
+      for(size_t j = 0; j < count; j++)
+      {
+        double start = fpo ? (*fpo)[first+j] : 0;
+        double end = fpn ? (*fpn)[first+j] : 0;
+        splineRightSide(knots, ys[first+j].data(), clamped, start, end, alpha.data()+j, BLOCK);
+      }
+
+      //forward sweep
+      for(int j = 0; j < BLOCK; j++)
+        alpha[j] *= inversePivot[0];
+      for(size_t i = 1; i <= n; i++)
+      {
+        double* row = alpha.data() + i*BLOCK;
+        const double* previous = row - BLOCK;
+        for(int j = 0; j < BLOCK; j++)
+          row[j] = (row[j] - sub[i]*previous[j])*inversePivot[i];
+      }
+
+      //back substitution, counting i down from n-1 to 0
+      for(size_t i = n; i-- > 0; )
+      {
+        double* row = alpha.data() + i*BLOCK;
+        const double* next = row + BLOCK;
+        for(int j = 0; j < BLOCK; j++)
+          row[j] -= upper[i]*next[j];
+      }
+
+      std::vector<double> c(n+1);
+      for(size_t j = 0; j < count; j++)
+      {
+        for(size_t i = 0; i <= n; i++)
+          c[i] = alpha[i*BLOCK + j];
+        result.push_back(buildSpline(knots, ys[first+j].data(), c));
+      }
+    }
+
+    //throws std::runtime_error if a series doesn't have one y-value per knot
+    //or there aren't end derivatives for every series
+    std::vector<CubicSpline> fitAll(const std::vector<std::vector<double>>& ys, const std::vector<double>* fpo, const std::vector<double>* fpn) const
+    {
+      for(size_t j = 0; j < ys.size(); j++)
+      {
+        if(ys[j].size() != knots.size())
+          throw std::runtime_error("series " + std::to_string(j) + " has " + std::to_string(ys[j].size()) + " y-values for " + std::to_string(knots.size()) + " knots");
+      }
+      if(fpo && (fpo->size() < ys.size() || fpn->size() < ys.size()))
+        throw std::runtime_error("there must be an end derivative at x_0 and x_n for each of the " + std::to_string(ys.size()) + " series");
+
+      std::vector<CubicSpline> result;
+      result.reserve(ys.size());
+      for(size_t first = 0; first < ys.size(); first += BLOCK)
+        fitBlock(ys, first, std::min<size_t>(BLOCK, ys.size() - first), fpo, fpn, result);
+      return result;
+    }
+
+  public:
+    //factors the system for natural splines, or clamped splines if clamped is true, through knots
+    SplineFactorization(std::vector<double> knots, bool clamped = false)
+      : knots(std::move(knots)), clamped(clamped)
+    {
+      std::vector<double> diag;
+      splineSystem(this->knots, clamped, sub, diag, upper);
+
+      //the forward sweep of the Thomas algorithm only touches the matrix
+      size_t n = this->knots.size()-1;
+      inversePivot.resize(n+1);
+      inversePivot[0] = 1/diag[0];
+      upper[0] *= inversePivot[0];
+      for(size_t i = 1; i <= n; i++)
+      {
+        inversePivot[i] = 1/(diag[i] - sub[i]*upper[i-1]);
+        upper[i] *= inversePivot[i];
+      }
+    }
+
+    //fits a natural spline to each list of y-values in ys
+    //throws std::runtime_error if the factorization is clamped, since the end derivatives are needed
+    //or if a list doesn't have one y-value per knot
+    std::vector<CubicSpline> fit(const std::vector<std::vector<double>>& ys) const
+    {
+      if(clamped)
+        throw std::runtime_error("a clamped factorization needs the end derivatives of each series");
+      return fitAll(ys, nullptr, nullptr);
+    }
+
+    //fits a clamped spline to each list of y-values in ys
+    //fpo[j] and fpn[j] are the derivatives at x_0 and x_n for ys[j]
+    //they are ignored by a natural factorization
+    //throws std::runtime_error if a list doesn't have one y-value per knot or fpo or fpn is shorter than ys
+    std::vector<CubicSpline> fit(const std::vector<std::vector<double>>& ys, const std::vector<double>& fpo, const std::vector<double>& fpn) const
+    {
+      return fitAll(ys, &fpo, &fpn);
+    }
+};
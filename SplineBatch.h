@@ -0,0 +1,114 @@
+//functions to fit many independent cubic splines at once
+#pragma once
+#include "Spline.h"
+#include "ThreadPool.h"
+#include "Metrics.h"
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+//one set of points to fit a spline through and its boundary conditions
+//fpo and fpn are the derivatives at x_0 and x_n and are only used when clamped is true
+struct SplineProblem
+{
+  std::vector<double> x;
+  std::vector<double> y;
+  bool clamped = false;
+  double fpo = 0;
+  double fpn = 0;
+};
+
+//class to hold many splines in one contiguous array
+//each spline's block of constants is stored back to back, laid out the way CubicSplineView reads it
+class SplineBatch
+{
+  private:
+    std::vector<double> storage;
+    //offsets[i] is where the ith spline's block starts and offsets[size()] is the end of the last one
+    std::vector<size_t> offsets;
+
+  public:
+    //makes room for a spline through each set of points in problems
+    //throws std::runtime_error if a problem has fewer than two points or x and y differ in length
+    explicit SplineBatch(const std::vector<SplineProblem>& problems) : offsets(problems.size()+1, 0)
+    {
+      for(size_t i = 0; i < problems.size(); i++)
+      {
+        size_t points = problems[i].x.size();
+        if(points < 2 || problems[i].y.size() != points)
+          throw std::runtime_error("spline problem " + std::to_string(i) + " needs at least two points with one y-value each");
+        offsets[i+1] = offsets[i] + 5*(points-1)+1;
+      }
+      storage.resize(offsets.back());
+    }
+
+    //returns how many splines are in the batch
+    size_t size() const
+    {
+      return offsets.size()-1;
+    }
+
+    //returns the ith spline
+    CubicSplineView operator[](size_t i) const
+    {
+      return CubicSplineView(storage.data() + offsets[i], (offsets[i+1] - offsets[i] - 1)/5);
+    }
+
+    //returns the start of the ith spline's block
+    double* data(size_t i)
+    {
+      return storage.data() + offsets[i];
+    }
+};
+
+//problems are handed to the pool in tasks of at least this many points
+//so the cost of scheduling a task is small next to the work in it
+const size_t BATCH_TASK_POINTS = 1 << 14;
+
+//fits a natural or clamped spline through problem and writes it into block
+//sub, diag, super and alpha are scratch space reused from one fit to the next
+void fitSplineInto(const SplineProblem& problem, std::vector<double>& sub, std::vector<double>& diag, std::vector<double>& super, std::vector<double>& alpha, double* block)
+{
+  splineSystem(problem.x, problem.clamped, sub, diag, super);
+  alpha.resize(problem.x.size());
+  splineRightSide(problem.x, problem.y.data(), problem.clamped, problem.fpo, problem.fpn, alpha.data(), 1);
+  solveTridiagonal(sub, diag, super, alpha);
+  writeSpline(problem.x.data(), problem.y.data(), alpha.data(), problem.x.size()-1, block);
+}
+
+//fits a spline through every problem concurrently on pool
+//neighbouring problems are grouped into tasks so each thread fits many small splines in a row,
+//and every task writes into its own part of the batch so no locking is needed
+SplineBatch fitSplines(const std::vector<SplineProblem>& problems, ThreadPool& pool)
+{
+  SplineBatch batch(problems);
+
+  size_t first = 0;
+  while(first < problems.size())
+  {
+    size_t last = first;
+    size_t points = 0;
+    while(last < problems.size() && points < BATCH_TASK_POINTS)
+      points += problems[last++].x.size();
+
+    pool.submit([&problems, &batch, first, last]()
+    {
+      METRICS_SCOPE("spline.batchTask");
+      METRICS_COUNT("spline.batchFits", last - first);
+      std::vector<double> sub, diag, super, alpha;
+      for(size_t i = first; i < last; i++)
+        fitSplineInto(problems[i], sub, diag, super, alpha, batch.data(i));
+    });
+    first = last;
+  }
+  pool.wait();
+  return batch;
+}
+
+//fits a spline through every problem on a pool with one thread per core
+SplineBatch fitSplines(const std::vector<SplineProblem>& problems)
+{
+  ThreadPool pool;
+  return fitSplines(problems, pool);
+}
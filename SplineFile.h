@@ -0,0 +1,125 @@
+//functions to save cubic splines to binary files and map them back into memory
+#pragma once
+#include "Spline.h"
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//a spline file is this header followed by the spline's block of 5n+1 doubles exactly as
+//CubicSplineView reads it, so a mapped file is used in place without any parsing
+//the header is 32 bytes so the block that follows stays aligned for doubles
+struct SplineFileHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  //written as ENDIAN_MARKER, so a file from a machine with the other byte order reads it reversed
+  std::uint32_t endian;
+  std::uint64_t count;
+  //FNV-1a hash of the bytes of the block
+  std::uint64_t checksum;
+};
+static_assert(sizeof(SplineFileHeader) == 32, "the spline file header must be 32 bytes");
+
+const char SPLINE_FILE_MAGIC[8] = {'S', 'P', 'L', 'I', 'N', 'E', 0, 0};
+const std::uint32_t SPLINE_FILE_VERSION = 1;
+const std::uint32_t ENDIAN_MARKER = 0x01020304;
+
+//returns the 64-bit FNV-1a hash of the size bytes at data
+std::uint64_t fnv1a(const void* data, size_t size)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  std::uint64_t hash = 14695981039346656037ull;
+  for(size_t i = 0; i < size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+//writes spline to fileName
+//throws std::runtime_error if the file can't be written
+void saveSpline(const CubicSplineView& spline, const std::string& fileName)
+{
+  size_t bytes = (5*(size_t)spline.size()+1)*sizeof(double);
+  SplineFileHeader header;
+  std::memcpy(header.magic, SPLINE_FILE_MAGIC, sizeof(header.magic));
+  header.version = SPLINE_FILE_VERSION;
+  header.endian = ENDIAN_MARKER;
+  header.count = spline.size();
+  header.checksum = fnv1a(spline.data(), bytes);
+
+  std::ofstream file(fileName, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(spline.data()), bytes);
+  file.close();
+  if(!file)
+    throw std::runtime_error("could not write " + fileName);
+}
+
+//class to read a spline file that is memory mapped instead of loaded
+//pages are only read from disk as the cubics on them are used
+class MappedSpline : public CubicSplineView
+{
+  private:
+    void* mapping;
+    size_t mappedSize;
+
+  public:
+    //maps the spline saved in fileName
+    //verifying the checksum reads the whole file, so pass verify = false to start evaluating right away
+    //throws std::runtime_error if the file isn't a spline file this version can read, or is damaged
+    explicit MappedSpline(const std::string& fileName, bool verify = true)
+      : CubicSplineView(nullptr, 0), mapping(MAP_FAILED), mappedSize(0)
+    {
+      int fd = open(fileName.c_str(), O_RDONLY);
+      if(fd < 0)
+        throw std::runtime_error("could not open " + fileName);
+
+      struct stat info;
+      fstat(fd, &info);
+      mappedSize = info.st_size;
+      if(mappedSize >= sizeof(SplineFileHeader))
+        mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if(mapping == MAP_FAILED)
+        throw std::runtime_error(fileName + " is not a spline file");
+
+      const SplineFileHeader* header = static_cast<const SplineFileHeader*>(mapping);
+      const char* problem = nullptr;
+      if(std::memcmp(header->magic, SPLINE_FILE_MAGIC, sizeof(header->magic)) != 0)
+        problem = " is not a spline file";
+      else if(header->endian != ENDIAN_MARKER)
+        problem = " was written on a machine with a different byte order";
+      else if(header->version != SPLINE_FILE_VERSION)
+        problem = " has an unsupported version";
+      else if(header->count == 0 || header->count > mappedSize/(5*sizeof(double)) || mappedSize != sizeof(SplineFileHeader) + (5*header->count+1)*sizeof(double))
+        problem = " is the wrong size for its spline";
+
+      const double* block = reinterpret_cast<const double*>(header+1);
+      if(problem == nullptr && verify && fnv1a(block, mappedSize - sizeof(SplineFileHeader)) != header->checksum)
+        problem = " failed its checksum";
+
+      if(problem != nullptr)
+      {
+        munmap(mapping, mappedSize);
+        throw std::runtime_error(fileName + problem);
+      }
+      bind(block, header->count);
+    }
+
+    MappedSpline(const MappedSpline&) = delete;
+    MappedSpline& operator=(const MappedSpline&) = delete;
+
+    ~MappedSpline()
+    {
+      munmap(mapping, mappedSize);
+    }
+};
@@ -0,0 +1,190 @@
+//class to run many small tasks on a fixed set of threads
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+//every thread has its own queue of tasks
+//a thread takes new work from the back of its own queue and, when that is empty,
+//steals from the front of another thread's queue, so busy threads rarely share a lock
+class ThreadPool
+{
+  private:
+    struct Queue
+    {
+      std::mutex lock;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    //queued counts tasks waiting in a queue and pending counts tasks that haven't finished
+    std::atomic<size_t> queued;
+    std::atomic<size_t> pending;
+    std::atomic<size_t> nextQueue;
+    bool stopping;
+
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    //the first exception thrown by a task since the last call to wait
+    std::exception_ptr error;
+    std::mutex errorLock;
+
+    //the pool and queue of the worker running on this thread, if there is one
+    inline static thread_local const ThreadPool* owner = nullptr;
+    inline static thread_local int self = 0;
+
+    //runs one task, looking in queue first and then stealing from the others
+    //returns false if every queue was empty
+    bool runOne(int queue)
+    {
+      std::function<void()> task;
+      int n = queues.size();
+      for(int k = 0; k < n && !task; k++)
+      {
+        Queue& q = *queues[(queue + k) % n];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if(q.tasks.empty())
+          continue;
+        if(k == 0)
+        {
+          task = std::move(q.tasks.back());
+          q.tasks.pop_back();
+        }
+        else
+        {
+          task = std::move(q.tasks.front());
+          q.tasks.pop_front();
+        }
+      }
+      if(!task)
+        return false;
+      queued--;
+
+      try
+      {
+        task();
+      }
+      catch(...)
+      {
+        std::lock_guard<std::mutex> guard(errorLock);
+        if(!error)
+          error = std::current_exception();
+      }
+
+      if(--pending == 0)
+      {
+        //taking the lock makes sure a thread in wait() is either asleep or about to see pending == 0
+        { std::lock_guard<std::mutex> guard(sleepLock); }
+        done.notify_all();
+      }
+      return true;
+    }
+
+    void work(int index)
+    {
+      owner = this;
+      self = index;
+      while(true)
+      {
+        if(runOne(index))
+          continue;
+
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wake.wait(guard, [&]() { return stopping || queued > 0; });
+        if(stopping && queued == 0)
+          return;
+      }
+    }
+
+  public:
+    //threads counts the thread that calls wait(), which runs tasks while it waits,
+    //so threads-1 workers are started
+    explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency())
+      : queued(0), pending(0), nextQueue(0), stopping(false)
+    {
+      threads = std::max(1u, threads);
+      for(unsigned t = 0; t < threads; t++)
+        queues.push_back(std::make_unique<Queue>());
+      for(unsigned t = 1; t < threads; t++)
+        workers.emplace_back(&ThreadPool::work, this, t);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    //finishes every task that was submitted and stops the workers
+    //whatever the workers leave, which is everything when the pool has a single thread,
+    //is run on the calling thread
+    //exceptions from those tasks are dropped since there is no later wait() to rethrow them
+    ~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+      }
+      wake.notify_all();
+      for(auto& worker : workers)
+        worker.join();
+      while(runOne(0))
+        ;
+    }
+
+    //returns how many threads run tasks, counting the one that calls wait()
+    int size() const
+    {
+      return queues.size();
+    }
+
+    //adds task to the pool
+    //a task submitted by another task goes on its worker's own queue so it is likely to run
+    //on the same thread, and other tasks are spread over the queues in turn
+    void submit(std::function<void()> task)
+    {
+      int index = owner == this ? self : nextQueue++ % queues.size();
+      pending++;
+      //count the task before it can be taken so queued never drops below zero
+      {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        queued++;
+      }
+      {
+        std::lock_guard<std::mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(std::move(task));
+      }
+      wake.notify_one();
+    }
+
+    //runs tasks on the calling thread until every submitted task has finished
+    //rethrows the first exception a task threw
+    void wait()
+    {
+      int index = owner == this ? self : 0;
+      while(pending > 0)
+      {
+        if(runOne(index))
+          continue;
+
+        std::unique_lock<std::mutex> guard(sleepLock);
+        done.wait(guard, [&]() { return pending == 0 || queued > 0; });
+      }
+
+      std::lock_guard<std::mutex> guard(errorLock);
+      if(error)
+      {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+      }
+    }
+};
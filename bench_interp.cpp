@@ -0,0 +1,244 @@
+#include "Polynomial.h"
+#include "Lagrange.h"
+#include "ChebyshevPolynomial.h"
+#include "Spline.h"
+#include "IncrementalSpline.h"
+#include "SplineFile.h"
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include <cstdio>
+#include <iostream>
+using namespace std;
+
+//every call to operator new is counted so the benchmarks can report allocations per operation
+atomic<long long> allocations(0);
+
+//the replacements below get their memory from these two functions, which are kept out of line
+//so GCC can't see free called on a pointer that came from operator new and warn about a mismatch
+__attribute__((noinline)) void* countedAllocate(size_t size, size_t alignment)
+{
+  allocations++;
+  void* p = alignment == 0 ? malloc(size == 0 ? 1 : size) : aligned_alloc(alignment, (size + alignment - 1)/alignment*alignment);
+  if(p == nullptr)
+    throw bad_alloc();
+  return p;
+}
+
+__attribute__((noinline)) void release(void* p) noexcept
+{
+  free(p);
+}
+
+void* operator new(size_t size)
+{
+  return countedAllocate(size, 0);
+}
+
+void operator delete(void* p) noexcept
+{
+  release(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  release(p);
+}
+
+//over-aligned requests, such as the chunks of a std::pmr arena, come through here
+void* operator new(size_t size, align_val_t alignment)
+{
+  return countedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p, align_val_t) noexcept
+{
+  release(p);
+}
+
+void operator delete(void* p, size_t, align_val_t) noexcept
+{
+  release(p);
+}
+
+//results are added to this so the compiler can't throw the benchmarked work away
+volatile double sink = 0;
+
+//each benchmark repeats until it has run for at least this long
+const double MIN_SECONDS = 0.2;
+
+bool firstResult = true;
+
+//times op, which processes size items, and prints one JSON object with the results
+template <typename Op>
+void bench(string name, long long size, Op op)
+{
+  long long iterations = 0;
+  long long startAllocations = allocations;
+  auto start = chrono::steady_clock::now();
+  double seconds = 0;
+  while(seconds < MIN_SECONDS)
+  {
+    op();
+    iterations++;
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+  long long used = allocations - startAllocations;
+
+  cout << (firstResult ? "\n" : ",\n");
+  firstResult = false;
+  cout << "    {\"name\": \"" << name << "\""
+       << ", \"size\": " << size
+       << ", \"iterations\": " << iterations
+       << ", \"ns_per_op\": " << seconds*1e9/iterations
+       << ", \"items_per_second\": " << size*iterations/seconds
+       << ", \"allocations_per_op\": " << (double)used/iterations << "}" << flush;
+}
+
+//returns n points with increasing x-values and random y-values
+vector<pair<double, double>> randomPoints(int n, mt19937& rng)
+{
+  uniform_real_distribution<double> uniform(0.0, 1.0);
+  vector<pair<double, double>> points(n);
+  double x = 0;
+  for(int i = 0; i < n; i++)
+  {
+    x += 0.5 + uniform(rng);
+    points[i] = make_pair(x, uniform(rng));
+  }
+  return points;
+}
+
+//returns a polynomial of degree n with random coefficients in [-1, 1]
+Polynomial randomPolynomial(int n, mt19937& rng)
+{
+  uniform_real_distribution<double> uniform(-1.0, 1.0);
+  vector<double> coefficients(n+1);
+  for(auto& c : coefficients)
+    c = uniform(rng);
+  coefficients[n] = 1;
+  return Polynomial(coefficients);
+}
+
+//usage: bench_interp [largest size]
+//sizes go up by factors of 10 from 10 to the largest size, which defaults to 10^7
+//the quadratic and superlinear benchmarks stop at smaller sizes so a run finishes in reasonable time
+int main(int argc, char* argv[])
+{
+  long long maxSize = argc > 1 ? atoll(argv[1]) : 10000000;
+  const long long QUADRATIC_LIMIT = 1000;
+  const long long POLYNOMIAL_LIMIT = 100000;
+  const long long APPEND_LIMIT = 1000000;
+  const long long FILE_LIMIT = 1000000;
+
+  mt19937 rng(335);
+  cout << "{\n  \"benchmarks\": [";
+
+  for(long long n = 10; n <= maxSize; n *= 10)
+  {
+    if(n <= QUADRATIC_LIMIT)
+    {
+      //Chebyshev points on [-2, 2] keep the barycentric weights from overflowing
+      vector<pair<double, double>> points(n);
+      for(int i = 0; i < n; i++)
+        points[i] = make_pair(2*cos(M_PI*(2*i+1)/(2*n)), sin(3.0*i));
+      bench("lagrange", n, [&]() { sink = sink + lagrange(points)[0]; });
+
+      //expanding into powers of x builds a few polynomial temporaries per coefficient
+      vector<double> chebyshevCoefficients(n);
+      for(int i = 0; i < n; i++)
+        chebyshevCoefficients[i] = sin(3.0*i);
+      ChebyshevPolynomial chebyshev(chebyshevCoefficients, -2, 2);
+      bench("ChebyshevPolynomial::toPolynomial", n, [&]() { sink = sink + chebyshev.toPolynomial()[0]; });
+    }
+
+    vector<pair<double, double>> points = randomPoints(n, rng);
+    bench("cubicSpline", n, [&]() { sink = sink + cubicSpline(points).evaluate(points[0].first); });
+    bench("clampedCubicSpline", n, [&]() { sink = sink + clampedCubicSpline(points, 1.0, -1.0).evaluate(points[0].first); });
+
+    if(n <= APPEND_LIMIT)
+    {
+      //the same points arriving one at a time, kept in full and in a sliding window
+      bench("IncrementalSpline::append", n, [&]()
+      {
+        IncrementalSpline spline;
+        for(auto& point : points)
+          spline.append(point.first, point.second);
+        sink = sink + spline.toSpline().evaluate(points[0].first);
+      });
+      bench("IncrementalSpline::append window", n, [&]()
+      {
+        IncrementalSpline spline(1000);
+        for(auto& point : points)
+          spline.append(point.first, point.second);
+        sink = sink + spline.evaluate(points.back().first);
+      });
+    }
+
+    if(n <= FILE_LIMIT)
+    {
+      //a spline is saved once per run and then mapped back, which checks the whole block's checksum
+      CubicSpline saved = cubicSpline(points);
+      const char* fileName = "bench_spline.bin";
+      bench("saveSpline", n, [&]() { saveSpline(saved, fileName); });
+      bench("MappedSpline", n, [&]()
+      {
+        MappedSpline mapped(fileName);
+        sink = sink + mapped.evaluate(mapped.getKnot(mapped.size()/2));
+      });
+      remove(fileName);
+    }
+
+    points = vector<pair<double, double>>();
+
+    if(n <= POLYNOMIAL_LIMIT)
+    {
+      Polynomial a = randomPolynomial(n, rng);
+      Polynomial b = randomPolynomial(n, rng);
+      bench("Polynomial::operator*", n, [&]() { sink = sink + (a*b)[0]; });
+
+      Polynomial base({-1, 1});
+      bench("Polynomial::power", n, [&]() { sink = sink + base.power(n)[0]; });
+
+      //q has positive coefficients so q(x) - q(1) is increasing and convex for x > 0 and its only
+      //positive root is 1, so Newton's method started to the right of 1 decreases monotonically to it
+      //starting at 1 + 1/n keeps x^n near e so the first steps don't overflow
+      uniform_real_distribution<double> positive(0.5, 1.0);
+      vector<double> coefficients(n+1);
+      double atOne = 0;
+      for(auto& c : coefficients)
+      {
+        c = positive(rng);
+        atOne += c;
+      }
+      coefficients[0] -= atOne;
+      Polynomial p(coefficients);
+      double start = 1 + 1.0/n;
+      if(p.newton(start).converged)
+        bench("Polynomial::root", n, [&]() { sink = sink + p.root(start); });
+      else
+        cerr << "skipping Polynomial::root at size " << n << " because Newton's method didn't converge" << endl;
+    }
+
+    //evaluate a degree 3 polynomial, the size of a spline cubic, at n points at once
+    Polynomial cubic = randomPolynomial(3, rng);
+    vector<double> xs(n), ys(n);
+    for(long long i = 0; i < n; i++)
+      xs[i] = (double)i/n;
+    bench("Polynomial::evaluate", n, [&]() { cubic.evaluate(xs.data(), ys.data(), n); sink = sink + ys[n-1]; });
+  }
+
+  cout << "\n  ]\n}" << endl;
+
+#ifdef INTERP_METRICS
+  //the counters and stage timings of every run go to their own file so the results stay valid JSON
+  ofstream metricsFile("bench_metrics.json");
+  writeMetricsJson(metricsFile);
+#endif
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include "Polynomial.h"
+#include "FixedPolynomial.h"
+#include "Spline.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+#include <iostream>
+using namespace std;
+
+//checks behavior that the homework programs don't exercise
+int main()
+{
+  //multiplying by an int literal converts it to the coefficient type
+  FixedPolynomial<2> f = {1, 2, 3};
+  FixedPolynomial<2> doubled = 2*f;
+  assert(doubled[0] == 2 && doubled[1] == 4 && doubled[2] == 6);
+
+  //Newton's and Halley's methods give up as soon as the iterate stops being finite
+  //x^400 - 1 is so flat at 0.5 that Newton's first step lands where x^400 overflows
+  //and Halley's method started at 10 overflows right away
+  vector<double> coefficients(401, 0.0);
+  coefficients[0] = -1;
+  coefficients[400] = 1;
+  Polynomial steep(coefficients);
+  RootResult<double> newton = steep.newton(0.5);
+  assert(!newton.converged && newton.iterations < 10 && isfinite(newton.root));
+  RootResult<double> halley = steep.halley(10);
+  assert(!halley.converged && halley.iterations < 10 && isfinite(halley.root));
+
+  //the parallel tridiagonal solve matches the serial one to within 1e-13 times the largest |x_i|
+  //7 threads on 5 rows leaves blocks of one row
+  for(int n : {5, 40, 1000})
+  {
+    vector<double> sub(n), diag(n), super(n), d(n);
+    for(int i = 0; i < n; i++)
+    {
+      sub[i] = i > 0 ? 1 + sin(1.0*i) : 0;
+      super[i] = i < n-1 ? 1 + cos(1.0*i) : 0;
+      diag[i] = sub[i] + super[i] + 1 + i%3;
+      d[i] = sin(0.5*i) + 1;
+    }
+    vector<double> serialSuper = super, serial = d;
+    solveTridiagonal(sub, diag, serialSuper, serial);
+    double largest = 0;
+    for(double x : serial)
+      largest = max(largest, fabs(x));
+
+    for(int threads : {1, 2, 3, 7})
+    {
+      vector<double> parallelSuper = super, parallel = d;
+      solveTridiagonalParallel(sub, diag, parallelSuper, parallel, threads);
+      for(int i = 0; i < n; i++)
+        assert(fabs(parallel[i] - serial[i]) <= 1e-13*largest);
+    }
+  }
+
+  //a factorization rejects a series that is too short and a clamped fit without end derivatives
+  SplineFactorization natural({0, 1, 2, 3});
+  bool threw = false;
+  try { natural.fit({{0, 1, 2}}); } catch(const runtime_error&) { threw = true; }
+  assert(threw);
+  threw = false;
+  try { SplineFactorization({0, 1, 2, 3}, true).fit({{0, 1, 2, 3}}); } catch(const runtime_error&) { threw = true; }
+  assert(threw);
+
+  //a pool with one thread runs its tasks on the calling thread, so its destructor has to run them
+  int ran = 0;
+  {
+    ThreadPool pool(1);
+    for(int i = 0; i < 3; i++)
+      pool.submit([&ran]() { ran++; });
+  }
+  assert(ran == 3);
+
+  cout << "All tests passed" << endl;
+}